@@ -0,0 +1,313 @@
+//
+//  ATBenchmark.cpp
+//  ATest
+//
+//  Measures the cost of ATest itself: the time spent in the framework around a trivial callable, the cost of
+//  each level of UnitGroup, the cost of launching a UnitThread, the memory used by each unit, the peak memory of
+//  units returning large results and the cost of writing and querying a binary result log.
+//
+//  Usage: atest_bench [max_units]
+//
+//  The result log section writes and queries a log of 5 * max_units records.
+//
+
+#include "ATTest.h"
+#include "ATUnitThread.h"
+#include "ATResultLog.h"
+
+#include <cstddef>
+#include <cstdlib>
+#include <cstdio>
+#include <cstring>
+#include <new>
+
+namespace
+{
+    //! @brief The number of bytes currently allocated through the global operator new.
+    std::atomic < size_t > g_allocated_bytes(0);
+
+    //! @brief The highest value reached by g_allocated_bytes since the last reset.
+    std::atomic < size_t > g_peak_bytes(0);
+
+    //! @brief The header prepended to each allocation to remember its size. Keeps the max_align_t alignment.
+    constexpr size_t kAllocationHeader = alignof(std::max_align_t) > sizeof(size_t) ? alignof(std::max_align_t) : sizeof(size_t);
+
+    void* counted_allocate(size_t size)
+    {
+        void* block = std::malloc(size + kAllocationHeader);
+
+        if (!block)
+            throw std::bad_alloc();
+
+        *static_cast < size_t* >(block) = size;
+        size_t allocated = g_allocated_bytes += size;
+        size_t peak = g_peak_bytes;
+
+        while (allocated > peak && !g_peak_bytes.compare_exchange_weak(peak, allocated))
+        {
+
+        }
+
+        return static_cast < char* >(block) + kAllocationHeader;
+    }
+
+    void counted_release(void* pointer)
+    {
+        if (!pointer)
+            return;
+
+        void* block = static_cast < char* >(pointer) - kAllocationHeader;
+        g_allocated_bytes -= *static_cast < size_t* >(block);
+        std::free(block);
+    }
+}
+
+void* operator new(size_t size) { return counted_allocate(size); }
+void* operator new[](size_t size) { return counted_allocate(size); }
+void operator delete(void* pointer) noexcept { counted_release(pointer); }
+void operator delete[](void* pointer) noexcept { counted_release(pointer); }
+void operator delete(void* pointer, size_t) noexcept { counted_release(pointer); }
+void operator delete[](void* pointer, size_t) noexcept { counted_release(pointer); }
+
+using namespace ATest;
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    //! @brief Prevents the compiler from removing the benchmarked calls.
+    std::atomic < size_t > g_sink(0);
+
+    int trivial_function()
+    {
+        return 1;
+    }
+
+    /** @brief Runs 'function' 'iterations' times and returns the mean time of one iteration in nanoseconds. */
+    template < typename Function >
+    double measure(size_t iterations, Function&& function)
+    {
+        auto start = Clock::now();
+
+        for (size_t i = 0; i < iterations; ++i)
+            function();
+
+        std::chrono::duration < double, std::nano > elapsed = Clock::now() - start;
+        return elapsed.count() / static_cast < double >(iterations);
+    }
+
+    /** @brief Builds 'depth' nested UnitGroup, the deepest holding one trivial unit. */
+    std::shared_ptr < UnitBase > make_nested_groups(size_t depth)
+    {
+        std::shared_ptr < UnitBase > unit = make_unit(1, trivial_function);
+
+        for (size_t level = 0; level < depth; ++level)
+        {
+            auto group = std::make_shared < UnitGroup >();
+            group->addUnit(unit);
+            unit = group;
+        }
+
+        return unit;
+    }
+
+    void bench_trivial_unit()
+    {
+        auto unit = make_unit(1, trivial_function);
+
+        double direct = measure(10000000, [](){ g_sink += trivial_function(); });
+        double through_unit = measure(10000000, [&unit](){ g_sink += unit->run(); });
+
+        std::printf("trivial unit\n");
+        std::printf("  direct call                  %10.2f ns\n", direct);
+        std::printf("  Unit::run()                  %10.2f ns\n", through_unit);
+        std::printf("  framework overhead           %10.2f ns\n", through_unit - direct);
+    }
+
+    void bench_group_levels()
+    {
+        const size_t iterations = 2000000;
+        double base = 0.0;
+
+        std::printf("group levels (one trivial unit at the bottom)\n");
+
+        for (size_t depth = 0; depth <= 8; depth = depth ? depth * 2 : 1)
+        {
+            auto unit = make_nested_groups(depth);
+            double elapsed = measure(iterations, [&unit](){ g_sink += unit->run(); });
+
+            if (depth == 0)
+            {
+                base = elapsed;
+                std::printf("  depth %zu                      %10.2f ns\n", depth, elapsed);
+            }
+
+            else
+            {
+                std::printf("  depth %zu                      %10.2f ns  (%.2f ns per level)\n",
+                            depth, elapsed, (elapsed - base) / static_cast < double >(depth));
+            }
+        }
+    }
+
+    void bench_unit_thread()
+    {
+        auto group = std::make_shared < UnitGroup >();
+        group->addUnit(make_unit(1, trivial_function));
+
+        UnitThread thread(group);
+
+        double elapsed = measure(2000, [&thread](){
+            thread.run();
+            g_sink += thread.wait();
+        });
+
+        std::printf("UnitThread\n");
+        std::printf("  run() + wait()               %10.2f ns\n", elapsed);
+    }
+
+    void bench_memory(size_t units)
+    {
+        size_t before = g_allocated_bytes;
+        auto start = Clock::now();
+
+        auto group = std::make_shared < UnitGroup >();
+
+        for (size_t i = 0; i < units; ++i)
+            group->addUnit(make_unit(1, trivial_function));
+
+        std::chrono::duration < double, std::nano > build = Clock::now() - start;
+        size_t used = g_allocated_bytes - before;
+
+        start = Clock::now();
+        g_sink += group->run();
+        std::chrono::duration < double, std::nano > run = Clock::now() - start;
+
+        double count = static_cast < double >(units);
+
+        std::printf("  %8zu units  %8.1f bytes/unit  %8.2f ns/unit build  %8.2f ns/unit run\n",
+                    units, static_cast < double >(used) / count, build.count() / count, run.count() / count);
+    }
+
+    std::vector < char > large_result(size_t size)
+    {
+        return std::vector < char >(size, 'a');
+    }
+
+    void bench_large_results(size_t units, size_t size)
+    {
+        auto expected = std::make_shared < const std::vector < char > >(size, 'a');
+        auto group = std::make_shared < UnitGroup >();
+
+        for (size_t i = 0; i < units; ++i)
+            group->addUnit(make_unit(expected, large_result, size));
+
+        size_t before = g_allocated_bytes;
+        g_peak_bytes = before;
+
+        g_sink += group->run();
+
+        double peak = static_cast < double >(g_peak_bytes - before) / static_cast < double >(size);
+        std::printf("  %8zu units of %zu MiB  peak %.2f results in memory while running\n", units, size >> 20, peak);
+    }
+
+    void bench_reporter(size_t units)
+    {
+        const char* path = "atest_bench.atrl";
+
+        auto group = std::make_shared < UnitGroup >();
+
+        for (size_t i = 0; i < units; ++i)
+            group->addUnit(make_unit(1, trivial_function));
+
+        auto writer = std::make_shared < ResultLogWriter >(path);
+        group->setReporter(writer);
+
+        auto start = Clock::now();
+        g_sink += group->run();
+        writer->close();
+        std::chrono::duration < double, std::nano > run = Clock::now() - start;
+
+        std::printf("  %8zu units  %8.2f ns/unit run with ResultLogWriter\n", units, run.count() / static_cast < double >(units));
+        std::remove(path);
+    }
+
+    void bench_result_log(size_t records)
+    {
+        const char* path = "atest_bench.atrl";
+        auto start = Clock::now();
+
+        {
+            ResultLogWriter writer(path);
+            ResultRecord record = {};
+
+            for (size_t i = 0; i < records; ++i)
+            {
+                std::string name = "suite/unit" + std::to_string(i);
+                bool failed = i % 1000 == 0;
+
+                record.id = unit_id(name);
+                record.duration = static_cast < int64_t >((i * 7919) % 1000003);
+                record.code = failed ? EResultInvalid : ENoError;
+
+                writer.append(record, name, failed ? "Result is invalid but function happened well." : "");
+            }
+
+            writer.close();
+        }
+
+        std::chrono::duration < double, std::milli > write = Clock::now() - start;
+
+        start = Clock::now();
+        ResultLog log(path);
+        std::chrono::duration < double, std::milli > open = Clock::now() - start;
+
+        start = Clock::now();
+        g_sink += failures(log).size();
+        std::chrono::duration < double, std::milli > failed = Clock::now() - start;
+
+        start = Clock::now();
+        g_sink += slowest(log, 10).size();
+        std::chrono::duration < double, std::milli > top = Clock::now() - start;
+
+        start = Clock::now();
+        g_sink += diff(log, log).size();
+        std::chrono::duration < double, std::milli > compared = Clock::now() - start;
+
+        std::printf("  %8zu records  write %8.1f ms  open %6.3f ms  failures %7.1f ms  slowest(10) %7.1f ms  diff %7.1f ms\n",
+                    records, write.count(), open.count(), failed.count(), top.count(), compared.count());
+
+        std::remove(path);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    size_t max_units = 1000000;
+
+    if (argc > 1)
+        max_units = std::strtoull(argv[1], nullptr, 10);
+
+    bench_trivial_unit();
+    bench_group_levels();
+    bench_unit_thread();
+
+    std::printf("units in one UnitGroup\n");
+
+    for (size_t units : { size_t(1000), size_t(100000), size_t(1000000) })
+    {
+        if (units <= max_units)
+            bench_memory(units);
+    }
+
+    std::printf("large results\n");
+
+    bench_large_results(16, 64 << 20);
+
+    std::printf("result log\n");
+
+    bench_reporter(std::min < size_t >(max_units, 100000));
+    bench_result_log(std::max < size_t >(max_units, 1000) * 5);
+
+    return g_sink == 0;
+}
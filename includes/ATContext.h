@@ -0,0 +1,106 @@
+//
+//  ATContext.h
+//  ATest
+//
+//  Created by jacques tronconi on 19/10/2026.
+//
+
+#ifndef ATContext_h
+#define ATContext_h
+
+#include "ATHistory.h"
+#include "ATProfiler.h"
+
+namespace ATest
+{
+    /** @brief A flag shared by groups to stop running their units after a failure.
+     *
+     *  When a group breaking on error has a failed subunit, it cancels its Cancellation: every group sharing it
+     *  (on any thread or worker) stops starting new units. Every group has one: a group breaking on error shares it
+     *  with its subunits, while a group that doesn't gives each subgroup its own Cancellation, cancelled with its
+     *  parent, so that a failure in one subgroup doesn't stop the others.
+     *
+     *  The groups sharing a Cancellation call 'begin' and 'end' around their run. A run beginning while no other run
+     *  uses the Cancellation starts uncancelled: groups runned together (from several UnitThreads for example) stop
+     *  on the first failure of any of them, and the next run starts again.
+     *
+     */
+    class Cancellation
+    {
+        //! @brief Twice the number of runs using this Cancellation, plus 1 if it is cancelled.
+        std::atomic < uint64_t > m_state;
+        
+        //! @brief The Cancellation of the enclosing run, or null.
+        std::shared_ptr < const Cancellation > m_parent;
+        
+    public:
+        /** @brief Constructs a Cancellation that is not cancelled, and is cancelled with 'parent' if not null. */
+        explicit Cancellation(const std::shared_ptr < const Cancellation >& parent = nullptr)
+        : m_state(0), m_parent(parent)
+        {
+            
+        }
+        
+        /** @brief Starts a run using this Cancellation. If no other run uses it, it is reset. */
+        void begin()
+        {
+            uint64_t state = m_state.load(std::memory_order_relaxed);
+            
+            while (!m_state.compare_exchange_weak(state, state < 2 ? 2 : state + 2, std::memory_order_acq_rel,
+                                                  std::memory_order_relaxed))
+            {
+                
+            }
+        }
+        
+        /** @brief Ends a run started with 'begin'. */
+        void end()
+        {
+            m_state.fetch_sub(2, std::memory_order_release);
+        }
+        
+        /** @brief Cancels the run. */
+        void cancel()
+        {
+            m_state.fetch_or(1, std::memory_order_release);
+        }
+        
+        /** @brief Returns true if the run, or the enclosing run, is cancelled. */
+        bool isCancelled() const
+        {
+            return (m_state.load(std::memory_order_acquire) & 1) || (m_parent && m_parent->isCancelled());
+        }
+        
+        /** @brief Allows the units to run again. */
+        void reset()
+        {
+            m_state.fetch_and(~uint64_t(1), std::memory_order_release);
+        }
+    };
+    
+    /** @brief The objects shared by a UnitGroup with all of its subunits.
+     *
+     *  A Context is given to a unit with UnitBase::attach(). Groups keep it and give it to their subunits, adding
+     *  their own name to \ref scope, thus every unit of a tree of groups shares the same Reporter and History.
+     *
+     */
+    struct Context
+    {
+        //! @brief The Reporter receiving the results of the units, or null.
+        std::shared_ptr < Reporter > reporter;
+
+        //! @brief The path of the group holding the unit.
+        std::string scope;
+        
+        //! @brief The History of the previous runs, or null.
+        std::shared_ptr < const History > history;
+        
+        //! @brief The Profiler sampling the units, or null.
+        std::shared_ptr < Profiler > profiler;
+        
+        //! @brief The Cancellation stopping the units after the first failure, or null.
+        std::shared_ptr < Cancellation > cancellation;
+    };
+}
+
+#endif /* ATContext_h */
@@ -19,7 +19,11 @@ namespace ATest
         EResultInvalid,
         ENoCallable,
         EReturnedError,
-        ENullSubUnit
+        ENullSubUnit,
+        EFileError,
+        EInvalidFormat,
+        EInvalidShard,
+        ECancelled
     };
     
     class Error : public std::exception
@@ -0,0 +1,166 @@
+//
+//  ATFixture.h
+//  ATest
+//
+//  Created by jacques tronconi on 19/10/2026.
+//
+
+#ifndef ATFixture_h
+#define ATFixture_h
+
+#include "ATContext.h"
+
+namespace ATest
+{
+    /** @brief The base for all fixtures.
+     *
+     *  A fixture is a state shared by several units, like a big dataset or an index, that is long to set up. The
+     *  fixture is set up the first time a unit asks for it, exactly once even if several threads ask for it
+     *  simultaneously, and is torn down when its last user releases it.
+     *
+     *  Users of a fixture are the UnitGroup holding it: a group retains its fixtures when it starts running and
+     *  releases them when it has finished, thus a fixture added to a group is shared by all units of the group and
+     *  of its subgroups, and by all groups runned simultaneously from different UnitThreads.
+     *
+     *  The time spent setting up a fixture is reported (with the kind EFixtureReport) to the Reporter of the group
+     *  holding it, and is not counted in the duration of the unit that triggered the set up.
+     *
+     */
+    class FixtureBase
+    {
+        //! @brief The name of this fixture.
+        std::string m_name;
+
+        //! @brief Protects the set up and the tear down of the fixture.
+        mutable std::mutex m_mutex;
+
+        //! @brief The instance of the fixture, or null when it isn't set up.
+        std::atomic < const void* > m_instance;
+
+        //! @brief The exception thrown by the set up, rethrown to each user until the tear down.
+        std::exception_ptr m_setup_error;
+
+        //! @brief The number of users.
+        size_t m_users = 0;
+
+        //! @brief The Context given by the group holding this fixture.
+        Context m_context;
+
+        //! @brief The time spent by the last set up.
+        std::chrono::nanoseconds m_setup_time;
+
+        /** @brief Destroys the instance. \ref m_mutex must be locked. */
+        void destroy_locked();
+
+    protected:
+        /** @brief Creates the instance of the fixture. */
+        virtual const void* setup() = 0;
+
+        /** @brief Destroys the instance created by 'setup'. */
+        virtual void teardown(const void* instance) = 0;
+
+        /** @brief Returns the instance, setting it up if needed.
+         *
+         *  @throw
+         *  The exception thrown by the set up.
+         */
+        const void* acquire();
+
+        /** @brief Destroys the instance if it is set up. Derived classes must call it in their destructor. */
+        void destroy();
+
+    public:
+        /** @brief Constructs a fixture. */
+        explicit FixtureBase(const std::string& name);
+
+        /** @brief The default destructor. */
+        virtual ~FixtureBase() = default;
+
+        FixtureBase(const FixtureBase&) = delete;
+        FixtureBase& operator=(const FixtureBase&) = delete;
+
+        /** @brief Returns the name of this fixture. */
+        const std::string& name() const;
+
+        /** @brief Adds a user. */
+        void retain();
+
+        /** @brief Removes a user. When the last user is removed, the fixture is torn down. */
+        void release();
+
+        /** @brief Returns true if the fixture is set up. */
+        bool isReady() const;
+
+        /** @brief Returns the time spent by the last set up of this fixture. */
+        std::chrono::nanoseconds setupTime() const;
+
+        /** @brief Keeps the Context used to report the set up. */
+        void attach(const Context& context);
+
+        /** @brief Returns the time spent setting up fixtures on the calling thread since it started, including the
+         *  time spent waiting for another thread to set them up.
+         *
+         *  UnitGroup subtracts the difference of this value before and after a unit from the unit's duration.
+         */
+        static std::chrono::nanoseconds threadSetupTime();
+    };
+
+    /** @brief A fixture holding a value of type T.
+     *
+     *  The value is created by the set up function given at construction, and units access it (read-only) with
+     *  'get'. Units receive the fixture as a std::shared_ptr < Fixture < T > > argument.
+     *
+     */
+    template < typename T >
+    class Fixture : public FixtureBase
+    {
+        //! @brief The function creating the value.
+        std::function < T(void) > m_setup_function;
+
+    protected:
+        /** @brief Creates the value with the set up function. */
+        const void* setup()
+        {
+            return new T(m_setup_function());
+        }
+
+        /** @brief Destroys the value. */
+        void teardown(const void* instance)
+        {
+            delete static_cast < const T* >(instance);
+        }
+
+    public:
+        /** @brief Constructs a fixture from its name and its set up function. */
+        Fixture(const std::string& name, const std::function < T(void) >& setup_function)
+        : FixtureBase(name), m_setup_function(setup_function)
+        {
+
+        }
+
+        /** @brief Tears down the fixture if it is still set up. */
+        ~Fixture()
+        {
+            destroy();
+        }
+
+        /** @brief Returns the value, setting it up if this is the first use.
+         *
+         *  @throw
+         *  The exception thrown by the set up function.
+         */
+        const T& get()
+        {
+            return *static_cast < const T* >(acquire());
+        }
+    };
+
+    /** @brief Creates a new Fixture holding a value of type T created by 'setup_function'. */
+    template < typename T, typename Function >
+    std::shared_ptr < Fixture < T > > make_fixture(const std::string& name, Function&& setup_function)
+    {
+        return std::make_shared < Fixture < T > >(name, std::function < T(void) >(std::forward < Function >(setup_function)));
+    }
+}
+
+#endif /* ATFixture_h */
@@ -0,0 +1,173 @@
+//
+//  ATGoldenFile.h
+//  ATest
+//
+//  Created by jacques tronconi on 19/10/2026.
+//
+
+#ifndef ATGoldenFile_h
+#define ATGoldenFile_h
+
+#include "ATUnit.h"
+
+namespace ATest
+{
+    /** @brief A read-only memory mapping of a file holding an expected result.
+     *
+     *  Mapping the file lets a unit compare a large result without reading the expected data into its own memory:
+     *  pages are loaded (and can be dropped) by the system as the comparison goes.
+     *
+     */
+    class GoldenFile
+    {
+        //! @brief The mapping of the file, or null if the file is empty.
+        const char* m_data = nullptr;
+
+        //! @brief The size of the file.
+        size_t m_size = 0;
+
+    public:
+        //! @brief The value returned by 'compare' when the data match the file.
+        static constexpr size_t npos = static_cast < size_t >(-1);
+
+        /** @brief Maps the file at the given path.
+         *
+         *  @throw
+         *  Error with EFileError if the file cannot be mapped.
+         */
+        explicit GoldenFile(const std::string& path);
+
+        /** @brief Unmaps the file. */
+        ~GoldenFile();
+
+        GoldenFile(const GoldenFile&) = delete;
+        GoldenFile& operator=(const GoldenFile&) = delete;
+
+        /** @brief Returns the content of the file. */
+        const void* data() const;
+
+        /** @brief Returns the size of the file. */
+        size_t size() const;
+
+        /** @brief Compares bytes to the file.
+         *
+         *  @return
+         *  npos if the bytes are the content of the file, otherwise the offset of the first difference.
+         */
+        size_t compare(const void* data, size_t size) const;
+    };
+
+    /** @brief A unit comparing the bytes of its result to a golden file.
+     *
+     *  The result must be a contiguous container of trivially copyable values (like std::vector < uint8_t >,
+     *  std::string or std::vector < float >). The golden file is mapped only during the comparison and the result
+     *  is destroyed right after it, thus the unit never holds more than its result.
+     *
+     */
+    template < typename Result >
+    class GoldenUnit : public UnitBase
+    {
+        using Element = std::remove_cv_t < std::remove_reference_t < decltype(*std::data(std::declval < const Result& >())) > >;
+
+        static_assert(std::is_trivially_copyable < Element >::value, "GoldenUnit needs a result made of trivially copyable values.");
+
+        //! @brief The function called by this unit.
+        std::function < Result(void) > m_callable;
+
+        //! @brief The path of the golden file.
+        std::string m_golden_path;
+
+        //! @brief A boolean true if this unit has been runned successfully.
+        std::atomic < bool > m_runned;
+
+        //! @brief A boolean true if this unit stores an error.
+        std::atomic < bool > m_error_happened;
+
+        //! @brief The error stored by this unit.
+        Error m_error;
+
+    public:
+        /** @brief Constructs a new unit.
+         *
+         *  @param golden_path
+         *  The path of the file holding the bytes expected.
+         *
+         *  @param func
+         *  The function to call when running this unit.
+         *
+         *  @param args
+         *  The arguments to pass to the function when running the unit.
+         */
+        template < typename... Args, typename... Params >
+        explicit GoldenUnit(const std::string& golden_path, Result(*func)(Args...), Params&&... args)
+        : m_golden_path(golden_path)
+        {
+            m_callable = std::bind(func, std::forward < Params >(args)...);
+            m_runned = false;
+            m_error_happened = false;
+        }
+
+        /** @brief Runs the test and returns true if it happens normally. */
+        bool run()
+        {
+            try
+            {
+                if (m_callable)
+                {
+                    size_t offset = GoldenFile::npos;
+
+                    {
+                        const Result result = m_callable();
+                        m_runned = true;
+
+                        GoldenFile golden(m_golden_path);
+                        offset = golden.compare(std::data(result), std::size(result) * sizeof(Element));
+                    }
+
+                    if (offset != GoldenFile::npos)
+                    {
+                        m_error_happened = true;
+                        m_error = Error(EResultInvalid, "Result differs from golden file '" + m_golden_path
+                                        + "' at byte " + std::to_string(offset) + ".");
+                    }
+
+                    else
+                    {
+                        m_error_happened = false;
+                        m_error = Error(ENoError, "");
+                    }
+                }
+
+                else
+                {
+                    m_runned = false;
+                    m_error_happened = true;
+                    m_error = Error(ENoCallable, "No callable for test unit.");
+                }
+            }
+
+            catch(const std::exception& e)
+            {
+                m_error_happened = true;
+                m_error = Error(EReturnedError, e.what());
+            }
+
+            return !m_error_happened;
+        }
+
+        /** @brief Returns an error result if the test failed. */
+        Error error() const
+        {
+            return m_error;
+        }
+    };
+
+    /** @brief Creates a new GoldenUnit comparing the result of a function to the content of a file. */
+    template < typename Result, typename... Args, typename... Params >
+    static std::shared_ptr < UnitBase > make_golden_unit(const std::string& golden_path, Result(*callable)(Args...), Params&&... args)
+    {
+        return std::make_shared < GoldenUnit < Result > >(golden_path, callable, std::forward<Params>(args)...);
+    }
+}
+
+#endif /* ATGoldenFile_h */
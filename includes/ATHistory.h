@@ -0,0 +1,80 @@
+//
+//  ATHistory.h
+//  ATest
+//
+//  Created by jacques tronconi on 19/10/2026.
+//
+
+#ifndef ATHistory_h
+#define ATHistory_h
+
+#include "ATResultLog.h"
+
+#include <unordered_map>
+
+namespace ATest
+{
+    /** @brief What is known of a unit from the previous runs. */
+    struct HistoryEntry
+    {
+        //! @brief The expected duration of the unit in nanoseconds: a moving average of the last durations.
+        int64_t duration = 0;
+
+        //! @brief The number of runs recorded for this unit.
+        uint32_t runs = 0;
+
+        //! @brief The number of failed runs recorded for this unit.
+        uint32_t failures = 0;
+
+        //! @brief The generation of the last failed run, or 0 if the unit never failed.
+        uint64_t last_failure = 0;
+    };
+
+    /** @brief The history of the units of a test, indexed by their stable identifier.
+     *
+     *  A History is updated from the result logs of each run with 'record', and saved between runs as a small text
+     *  file. Each recorded run increments the generation of the history.
+     *
+     */
+    class History
+    {
+        //! @brief The entries, by unit identifier.
+        std::unordered_map < uint64_t, HistoryEntry > m_entries;
+
+        //! @brief The number of runs recorded.
+        uint64_t m_generation = 0;
+
+    public:
+        /** @brief Loads a history file. If the file doesn't exist, returns an empty history.
+         *
+         *  @throw
+         *  Error with EInvalidFormat if the file is not a history file.
+         */
+        static History load(const std::string& path);
+
+        /** @brief Saves the history.
+         *
+         *  @throw
+         *  Error with EFileError if the file cannot be written.
+         */
+        void save(const std::string& path) const;
+
+        /** @brief Records a run. When a unit has several records in the log, they are all recorded. The records of
+         *  cancelled groups are skipped: their duration is cut short and they didn't fail by themselves. */
+        void record(const ResultLog& log);
+
+        /** @brief Records several logs as one run, like the logs of the shards of a run. */
+        void record(const std::vector < const ResultLog* >& logs);
+
+        /** @brief Returns the entry of a unit, or null if the unit was never recorded. */
+        const HistoryEntry* find(uint64_t id) const;
+
+        /** @brief Returns the number of runs recorded. */
+        uint64_t generation() const;
+
+        /** @brief Returns the number of units recorded. */
+        size_t size() const;
+    };
+}
+
+#endif /* ATHistory_h */
@@ -0,0 +1,107 @@
+//
+//  ATProfiler.h
+//  ATest
+//
+//  Created by jacques tronconi on 19/10/2026.
+//
+
+#ifndef ATProfiler_h
+#define ATProfiler_h
+
+#include "ATError.h"
+
+namespace ATest
+{
+    /** @brief A sampling profiler for the units of a UnitGroup.
+     *
+     *  When a Profiler is attached to a group (see UnitGroup::setProfiler()), the group samples the thread running
+     *  each of its units: a SIGPROF timer on the CPU time of the thread interrupts it at the given frequency and the
+     *  signal handler stores the current call stack into a buffer owned by the thread. Only the samples taken while
+     *  a unit's run() is executing are kept, and they are given to that unit.
+     *
+     *  The samples are aggregated by call stack and written by 'write' in the folded format read by flame graph
+     *  tools: one file per unit, named after the path of the unit, and 'all.folded' where each stack starts with the
+     *  path of its unit.
+     *
+     *  @note
+     *  On Linux, each thread has its own timer, thus units runned simultaneously from several UnitThreads are
+     *  profiled independently. Elsewhere, a single process-wide timer is used: samples are still given to the right
+     *  unit, but each thread is only sampled when it is the one interrupted.
+     *
+     *  On Linux x86-64 and AArch64, the signal handler walks the frame pointers of the interrupted thread, which
+     *  is async-signal-safe: build the profiled code with -fno-omit-frame-pointer, otherwise the stacks are cut (or
+     *  contain spurious frames) past the first function without one. Elsewhere, the handler falls back on
+     *  backtrace(), which isn't async-signal-safe: a sample taken while the thread is inside the dynamic loader or
+     *  the unwinder itself may deadlock or corrupt its state.
+     *
+     */
+    class Profiler
+    {
+        //! @brief The directory where the folded stacks are written.
+        std::string m_directory;
+
+        //! @brief The sampling frequency in Hertz.
+        unsigned m_frequency;
+
+        //! @brief The maximum number of samples kept for one run of one unit.
+        size_t m_max_samples;
+
+        //! @brief The number of samples of each stack, for each unit path.
+        std::map < std::string, std::map < std::string, size_t > > m_profiles;
+
+        //! @brief The number of samples lost because a unit ran longer than \ref m_max_samples samples.
+        size_t m_dropped = 0;
+
+        //! @brief The symbol of each address already symbolized.
+        std::map < void*, std::string > m_symbols;
+
+        //! @brief Protects the profiles when units end on several threads.
+        mutable std::mutex m_mutex;
+
+        /** @brief Returns the symbol of an address. \ref m_mutex must be locked. */
+        const std::string& symbol(void* address);
+
+    public:
+        /** @brief Constructs a profiler.
+         *
+         *  @param directory
+         *  The directory where 'write' writes the folded stacks. It is created if needed.
+         *
+         *  @param frequency
+         *  The number of samples per second of CPU time.
+         *
+         *  @param max_samples
+         *  The maximum number of samples kept for one run of one unit.
+         */
+        explicit Profiler(const std::string& directory, unsigned frequency = 997, size_t max_samples = 8192);
+
+        Profiler(const Profiler&) = delete;
+        Profiler& operator=(const Profiler&) = delete;
+
+        /** @brief Starts sampling the calling thread.
+         *
+         *  @return
+         *  False if the timer cannot be started, or if the thread is already sampled (by any Profiler) for an
+         *  enclosing unit: the unit then runs without being sampled, and 'end' must not be called for it.
+         */
+        bool begin();
+
+        /** @brief Stops sampling the calling thread and adds its samples to the profile of the unit. */
+        void end(const std::string& path);
+
+        /** @brief Returns the number of samples of each stack of a unit. Stacks are folded, from the root. */
+        std::map < std::string, size_t > profile(const std::string& path) const;
+
+        /** @brief Returns the number of samples dropped because a unit had more than 'max_samples' samples. */
+        size_t dropped() const;
+
+        /** @brief Writes the folded stacks of all units.
+         *
+         *  @throw
+         *  Error with EFileError if the directory or a file cannot be written.
+         */
+        void write() const;
+    };
+}
+
+#endif /* ATProfiler_h */
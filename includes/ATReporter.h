@@ -0,0 +1,78 @@
+//
+//  ATReporter.h
+//  ATest
+//
+//  Created by jacques tronconi on 19/10/2026.
+//
+
+#ifndef ATReporter_h
+#define ATReporter_h
+
+#include "ATError.h"
+
+namespace ATest
+{
+    /** @brief The kind of object a Report describes. */
+    enum ReportKind
+    {
+        EUnitReport = 0,
+        EGroupReport,
+        EFixtureReport
+    };
+
+    /** @brief The result of one run of one unit, as sent to a Reporter. */
+    struct Report
+    {
+        //! @brief The full path of the unit: the names of its parents and its own name, separated by '/'.
+        std::string path;
+
+        //! @brief The stable identifier of the unit, computed from \ref path with unit_id().
+        uint64_t id = 0;
+
+        //! @brief What was runned.
+        ReportKind kind = EUnitReport;
+
+        //! @brief The error returned by the unit. Its code is ENoError if the unit succeeded.
+        Error error;
+
+        //! @brief The time spent in the unit's run() function, without the set up of the fixtures it used. For a
+        //! fixture, the time spent setting it up.
+        std::chrono::nanoseconds duration = std::chrono::nanoseconds::zero();
+    };
+
+    /** @brief Receives the result of every unit runned by a UnitGroup.
+     *
+     *  A Reporter is given to a UnitGroup (or a Test) with UnitGroup::setReporter(). The group then measures each of
+     *  its subunits and calls 'report' after each of them has runned.
+     *
+     *  @note
+     *  The same Reporter may be shared by UnitGroups runned from different UnitThreads, thus 'report' must be
+     *  thread-safe.
+     *
+     */
+    class Reporter
+    {
+    public:
+        /** @brief The default destructor. */
+        virtual ~Reporter() = default;
+
+        /** @brief Receives the result of one unit. */
+        virtual void report(const Report& report) = 0;
+    };
+
+    /** @brief Returns the stable identifier of a unit from its path.
+     *
+     *  The identifier is the 64 bits FNV-1a hash of the path: it doesn't depend on the address of the unit nor on the
+     *  run, thus it can be used to compare two different runs.
+     *
+     *  @note
+     *  A unit added without a name to a UnitGroup is named after its index in the group: its identifier then
+     *  changes when units are inserted before it. Name the units to keep their identifiers stable.
+     */
+    uint64_t unit_id(const std::string& path);
+
+    /** @brief Joins a scope and a name with a '/'. If one of them is empty, returns the other one. */
+    std::string join_path(const std::string& scope, const std::string& name);
+}
+
+#endif /* ATReporter_h */
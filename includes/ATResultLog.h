@@ -0,0 +1,230 @@
+//
+//  ATResultLog.h
+//  ATest
+//
+//  Created by jacques tronconi on 19/10/2026.
+//
+
+#ifndef ATResultLog_h
+#define ATResultLog_h
+
+#include "ATReporter.h"
+
+namespace ATest
+{
+    /** @brief One fixed-size record of a result log.
+     *
+     *  Names and messages are not stored in the record but in the string table of the log, the record only keeps
+     *  their offset in this table. The offset 0 is always the empty string.
+     *
+     */
+    struct ResultRecord
+    {
+        //! @brief The stable identifier of the unit (see unit_id()).
+        uint64_t id;
+
+        //! @brief The time spent in the unit, in nanoseconds.
+        int64_t duration;
+
+        //! @brief The offset of the unit's path in the string table.
+        uint32_t name;
+
+        //! @brief The offset of the error message in the string table.
+        uint32_t message;
+
+        //! @brief The ErrorCode returned by the unit.
+        uint16_t code;
+
+        //! @brief The ReportKind of the record.
+        uint16_t kind;
+
+        //! @brief Unused, always zero.
+        uint32_t reserved;
+
+        /** @brief Returns true if the unit succeeded. */
+        bool passed() const
+        {
+            return code == ENoError;
+        }
+
+        /** @brief Returns true if the run of the group was cut short by a failure elsewhere (see Cancellation). */
+        bool cancelled() const
+        {
+            return code == ECancelled;
+        }
+
+        /** @brief Returns true if the unit failed by itself: neither passed nor cancelled. */
+        bool failed() const
+        {
+            return !passed() && !cancelled();
+        }
+    };
+
+    static_assert(sizeof(ResultRecord) == 32, "ResultRecord must stay 32 bytes long.");
+
+    /** @brief A Reporter writing every report into a binary result log.
+     *
+     *  The log is made of a header, the records in the order they were reported, the string table and a footer
+     *  locating the string table. Records are written through a large buffer while the test runs. As the string
+     *  table is written by 'close', a log whose writer was not closed (a crashed run) cannot be read.
+     *
+     *  Identical strings are only stored once, thus repeated samples of the same unit only cost one record each.
+     *
+     */
+    class ResultLogWriter : public Reporter
+    {
+        //! @brief The file descriptor of the log, or -1 when closed.
+        int m_file = -1;
+
+        //! @brief The records not yet written to the file.
+        std::vector < char > m_buffer;
+
+        //! @brief The string table.
+        std::string m_strings;
+
+        //! @brief An open-addressing table of the strings already in the string table. Each slot holds the
+        //! offset of a string and the low bits of its hash, or zero when the slot is empty.
+        std::vector < std::pair < uint32_t, uint32_t > > m_string_slots;
+
+        //! @brief The number of strings in \ref m_string_slots.
+        size_t m_string_count = 0;
+
+        //! @brief The number of records written.
+        uint64_t m_count = 0;
+
+        //! @brief Protects the writer when reports come from several threads.
+        std::mutex m_mutex;
+
+        /** @brief Returns the offset of the string in the string table, adding it if needed. */
+        uint32_t intern(const std::string& string);
+
+        /** @brief Writes the buffer to the file. */
+        void flush();
+
+    public:
+        /** @brief Creates (or truncates) the log at the given path.
+         *
+         *  @throw
+         *  Error with EFileError if the file cannot be opened.
+         */
+        explicit ResultLogWriter(const std::string& path);
+
+        /** @brief Closes the log if it was not closed. */
+        ~ResultLogWriter();
+
+        ResultLogWriter(const ResultLogWriter&) = delete;
+        ResultLogWriter& operator=(const ResultLogWriter&) = delete;
+
+        /** @brief Appends the report to the log. */
+        void report(const Report& report);
+
+        /** @brief Appends a record to the log. The name and message are interned in the string table.
+         *
+         *  @throw
+         *  Error with EFileError if the string table would grow over 4 GiB.
+         */
+        void append(const ResultRecord& record, const std::string& name, const std::string& message);
+
+        /** @brief Writes the string table and the footer, and closes the file.
+         *
+         *  @throw
+         *  Error with EFileError if the file cannot be written.
+         */
+        void close();
+
+        /** @brief Returns the number of records appended. */
+        uint64_t size() const;
+    };
+
+    /** @brief A read-only view on a result log.
+     *
+     *  The log is mapped in memory: opening it only checks its header and footer, and records and strings are
+     *  read directly from the mapping.
+     *
+     */
+    class ResultLog
+    {
+        //! @brief The mapping of the file.
+        const char* m_data = nullptr;
+
+        //! @brief The size of the mapping.
+        size_t m_size = 0;
+
+        //! @brief The first record.
+        const ResultRecord* m_records = nullptr;
+
+        //! @brief The number of records.
+        size_t m_count = 0;
+
+        //! @brief The string table.
+        const char* m_strings = nullptr;
+
+        //! @brief The size of the string table.
+        size_t m_strings_size = 0;
+
+    public:
+        /** @brief Maps the log at the given path.
+         *
+         *  @throw
+         *  Error with EFileError if the file cannot be mapped, or EInvalidFormat if it isn't a complete log.
+         */
+        explicit ResultLog(const std::string& path);
+
+        /** @brief Unmaps the log. */
+        ~ResultLog();
+
+        ResultLog(ResultLog&& rhs) noexcept;
+        ResultLog& operator=(ResultLog&& rhs) noexcept;
+
+        ResultLog(const ResultLog&) = delete;
+        ResultLog& operator=(const ResultLog&) = delete;
+
+        /** @brief Returns the number of records. */
+        size_t size() const;
+
+        /** @brief Returns the first record. */
+        const ResultRecord* begin() const;
+
+        /** @brief Returns the end of the records. */
+        const ResultRecord* end() const;
+
+        /** @brief Returns the record at the given index. */
+        const ResultRecord& operator[](size_t index) const;
+
+        /** @brief Returns the path of the unit of the record. */
+        const char* name(const ResultRecord& record) const;
+
+        /** @brief Returns the error message of the record. */
+        const char* message(const ResultRecord& record) const;
+    };
+
+    /** @brief One unit compared between two logs by diff(). */
+    struct ResultDiff
+    {
+        //! @brief The stable identifier of the unit.
+        uint64_t id;
+
+        //! @brief The record of the unit in the first log, or null if the unit wasn't runned.
+        const ResultRecord* before;
+
+        //! @brief The record of the unit in the second log, or null if the unit wasn't runned.
+        const ResultRecord* after;
+    };
+
+    /** @brief Returns the records of the failed units, in the order of the log. Cancelled groups are not listed. */
+    std::vector < const ResultRecord* > failures(const ResultLog& log);
+
+    /** @brief Returns the 'count' slowest records, the slowest first. */
+    std::vector < const ResultRecord* > slowest(const ResultLog& log, size_t count);
+
+    /** @brief Appends all records of a log to a writer, like the logs of the shards of a run. */
+    void merge(const ResultLog& log, ResultLogWriter& writer);
+    
+    /** @brief Matches the units of two logs by identifier.
+     *
+     *  When a unit has several records in a log, its last record is used. The result is sorted by identifier.
+     */
+    std::vector < ResultDiff > diff(const ResultLog& before, const ResultLog& after);
+}
+
+#endif /* ATResultLog_h */
@@ -0,0 +1,61 @@
+//
+//  ATShard.h
+//  ATest
+//
+//  Created by jacques tronconi on 19/10/2026.
+//
+
+#ifndef ATShard_h
+#define ATShard_h
+
+#include "ATHistory.h"
+
+namespace ATest
+{
+    /** @brief Selects the part of a test runned by one process when a test is split across several processes.
+     *
+     *  Every process runs the same test with the same History and a different index: as the partition only depends
+     *  on the units' identifiers and on the History, each unit is runned by exactly one process.
+     *
+     */
+    struct Shard
+    {
+        //! @brief The index of this shard, lower than \ref count.
+        size_t index = 0;
+
+        //! @brief The number of shards. A count of 1 runs all units.
+        size_t count = 1;
+
+        /** @brief Reads the shard from the ATEST_SHARD_INDEX and ATEST_SHARD_COUNT environment variables.
+         *
+         *  If ATEST_SHARD_COUNT is not set, returns the single shard running all units.
+         *
+         *  @throw
+         *  Error with EInvalidShard if the variables are not valid numbers or if the index is not lower than the count.
+         */
+        static Shard from_environment();
+    };
+
+    /** @brief Partitions units into shards of about the same duration.
+     *
+     *  Units are assigned in the longest-processing-time-first order: the longest unit goes to the shard with the
+     *  lowest total duration, and so on. The expected duration of a unit comes from the History; units unknown to
+     *  the History are expected to last the mean duration of the known ones. Ties are broken by identifier and
+     *  shard index, thus the partition is the same in every process.
+     *
+     *  @param ids
+     *  The stable identifiers of the units.
+     *
+     *  @param count
+     *  The number of shards.
+     *
+     *  @param history
+     *  The History of the units, or null to expect every unit to last the same time.
+     *
+     *  @return
+     *  The shard of each unit, in the order of 'ids'.
+     */
+    std::vector < size_t > partition(const std::vector < uint64_t >& ids, size_t count, const History* history);
+}
+
+#endif /* ATShard_h */
@@ -10,6 +10,7 @@
 #define ATStdIncludes_h
 
 #include <iostream>
+#include <cstdint>
 #include <functional>
 #include <atomic>
 #include <exception>
@@ -21,5 +22,6 @@
 #include <thread>
 #include <chrono>
 #include <future>
+#include <optional>
 
 #endif /* ATStdIncludes_h */
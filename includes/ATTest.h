@@ -15,8 +15,6 @@ namespace ATest
 {
     class Test : public UnitBase
     {
-        std::string m_name;
-        
         std::shared_ptr < UnitGroup > m_group;
         
     public:
@@ -25,11 +23,50 @@ namespace ATest
         
         void addUnit(const std::shared_ptr<UnitBase>& unit);
         
+        /** @brief Adds a fixture shared by all units of this test. */
+        void addFixture(const std::shared_ptr < FixtureBase >& fixture);
+        
         bool run();
         
         void throw_error();
         
         Error error() const;
+        
+        /** @brief Returns true: a test runs its units. */
+        bool holdsSubunits() const;
+        
+        /** @brief Attaches the Context to the units of this test, scoped by the name of the test.
+         *
+         *  A test attached to a parent group (a test added to another test for example) runs all its units: only
+         *  the top-level group is sharded.
+         */
+        void attach(const Context& context);
+        
+        /** @brief Attaches a Reporter to all units of this test. */
+        void setReporter(const std::shared_ptr < Reporter >& reporter);
+        
+        /** @brief Attaches the History of the previous runs to all units of this test. */
+        void setHistory(const std::shared_ptr < const History >& history);
+        
+        /** @brief Attaches a Profiler sampling all units of this test. */
+        void setProfiler(const std::shared_ptr < Profiler >& profiler);
+        
+        /** @brief Only runs the units of this test belonging to the given shard.
+         *
+         *  A Test is created with the shard given by Shard::from_environment(). It is cleared when the test is
+         *  attached to a parent group.
+         */
+        void setShard(const Shard& shard);
+        
+        /** @brief Sets the number of threads running the units of this test. */
+        void setWorkers(size_t workers);
+        
+        /** @brief If true (the default), the first failed unit stops the test. */
+        void setBreakOnError(bool should_break);
+        
+        /** @brief Attaches a Cancellation stopping this test (and every test sharing it) on the first failure. Only
+         *  a root test keeps it: see UnitGroup::setCancellation(). */
+        void setCancellation(const std::shared_ptr < Cancellation >& cancellation);
     };
 }
 
@@ -11,6 +11,7 @@
 
 #include "ATError.h"
 #include "ATComparator.h"
+#include "ATContext.h"
 
 namespace ATest
 {
@@ -21,13 +22,55 @@ namespace ATest
      *  'error' function. This simple base is derived into the Units (the class that perform an actual test) and
      *  the UnitGroup that groups multiple UnitBase.
      *
+     *  Each unit has a name, used to build its path in the results given to a Reporter. A unit added without a
+     *  name to a UnitGroup is named after its index in the group.
+     *
      */
     class UnitBase
     {
+        //! @brief The name of this unit.
+        std::string m_name;
+        
     public:
         /** @brief The default destructor. */
         virtual ~UnitBase() = default;
         
+        /** @brief Returns the name of this unit. */
+        const std::string& name() const
+        {
+            return m_name;
+        }
+        
+        /** @brief Changes the name of this unit.
+         *
+         *  @note
+         *  The name of a UnitGroup must be set before the group is attached to a Context, or it will not appear in
+         *  the path of its subunits.
+         */
+        void setName(const std::string& name)
+        {
+            m_name = name;
+        }
+        
+        /** @brief Gives a Context to this unit.
+         *
+         *  The default implementation does nothing: only units holding other units, like UnitGroup, need the
+         *  Context to give it to their subunits.
+         */
+        virtual void attach(const Context&)
+        {
+            
+        }
+        
+        /** @brief Returns true if this unit runs other units, like UnitGroup.
+         *
+         *  A unit holding subunits is reported as a group and is not sampled by a Profiler: its subunits are.
+         */
+        virtual bool holdsSubunits() const
+        {
+            return false;
+        }
+        
         /** @brief Runs the unit.
          *
          *  @return
@@ -61,11 +104,15 @@ namespace ATest
         //! @brief The function called by this unit.
         std::function < Result(void) > m_callable;
         
-        //! @brief The result expected.
-        Result m_normal_result;
+        //! @brief The result expected, when this unit owns it.
+        std::optional < Result > m_owned_result;
         
-        //! @brief The result returned by the callable.
-        Result m_result;
+        //! @brief The result expected, when this unit shares it.
+        std::shared_ptr < const Result > m_shared_result;
+        
+        //! @brief The result expected: points to \ref m_owned_result, \ref m_shared_result or a result owned by
+        //! the caller.
+        const Result* m_normal_result = nullptr;
         
         //! @brief A boolean true if this unit has been runned successfully.
         std::atomic < bool > m_runned;
@@ -87,19 +134,53 @@ namespace ATest
          *  the std::bind function.
          *
          *  @param normal_result
-         *  The result expected for this function with those arguments.
+         *  The result expected for this function with those arguments. It is copied into the unit.
          *
          *  @param func
          *  The function to call when running this unit.
          *
          *  @param args
-         *  The arguments to pass to the function when running the unit.
+         *  The arguments to pass to the function when running the unit. They are copied (or moved) into the unit and
+         *  only need to be convertible to the parameters of the function.
          */
-        template < typename... Args >
-        explicit Unit(const Result& normal_result, Result(*func)(Args...), Args&&... args)
+        template < typename... Args, typename... Params >
+        explicit Unit(const Result& normal_result, Result(*func)(Args...), Params&&... args)
+        {
+            m_callable = std::bind(func, std::forward < Params >(args)...);
+            m_owned_result.emplace(normal_result);
+            m_normal_result = &*m_owned_result;
+            m_runned = false;
+            m_error_happened = false;
+        }
+        
+        /** @brief Constructs a new unit, moving the expected result into the unit. */
+        template < typename... Args, typename... Params >
+        explicit Unit(Result&& normal_result, Result(*func)(Args...), Params&&... args)
+        {
+            m_callable = std::bind(func, std::forward < Params >(args)...);
+            m_owned_result.emplace(std::move(normal_result));
+            m_normal_result = &*m_owned_result;
+            m_runned = false;
+            m_error_happened = false;
+        }
+        
+        /** @brief Constructs a new unit comparing to a result owned by the caller, which must outlive the unit. */
+        template < typename... Args, typename... Params >
+        explicit Unit(std::reference_wrapper < const Result > normal_result, Result(*func)(Args...), Params&&... args)
+        {
+            m_callable = std::bind(func, std::forward < Params >(args)...);
+            m_normal_result = &normal_result.get();
+            m_runned = false;
+            m_error_happened = false;
+        }
+        
+        /** @brief Constructs a new unit sharing its expected result, for example with other units. */
+        template < typename... Args, typename... Params >
+        explicit Unit(const std::shared_ptr < const Result >& normal_result, Result(*func)(Args...), Params&&... args)
         {
-            m_callable = std::bind(func, std::forward < Args >(args)...);
-            m_normal_result = normal_result;
+            m_callable = std::bind(func, std::forward < Params >(args)...);
+            m_shared_result = normal_result;
+            m_normal_result = m_shared_result.get();
             m_runned = false;
             m_error_happened = false;
         }
@@ -111,10 +192,12 @@ namespace ATest
             {
                 if (m_callable)
                 {
-                    m_result = m_callable();
+                    // The result only lives until the comparison: it is never copied and a unit returning a large
+                    // buffer holds it only while it runs. Every constructor sets the expected result.
+                    bool valid = m_comparator.compare(m_callable(), *m_normal_result);
                     m_runned = true;
                     
-                    if (!m_comparator.compare(m_result, m_normal_result))
+                    if (!valid)
                     {
                         m_error_happened = true;
                         m_error = Error(EResultInvalid, "Result is invalid but function happened well.");
@@ -185,12 +268,13 @@ namespace ATest
          *  The function to call when running this unit.
          *
          *  @param args
-         *  The arguments to pass to the function when running the unit.
+         *  The arguments to pass to the function when running the unit. They are copied (or moved) into the unit and
+         *  only need to be convertible to the parameters of the function.
          */
-        template < typename... Args >
-        explicit Unit(void(*func)(Args...), Args&&... args)
+        template < typename... Args, typename... Params >
+        explicit Unit(void(*func)(Args...), Params&&... args)
         {
-            m_callable = std::bind(func, std::forward < Args >(args)...);
+            m_callable = std::bind(func, std::forward < Params >(args)...);
             m_runned = false;
             m_error_happened = false;
         }
@@ -234,35 +318,44 @@ namespace ATest
         }
     };
     
-    /** @brief Creates a new Unit with a non-void returning function and an expected result. */
-    template < typename Result,
+    /** @brief Creates a new Unit with a non-void returning function and an expected result.
+     *
+     *  The expected result may be a value (copied, or moved if it is a temporary), a std::cref() to a result owned by
+     *  the caller or a std::shared_ptr < const Result >.
+     */
+    template < typename Expected,
+        typename Result,
         typename... Args,
+        typename... Params,
         typename = std::enable_if_t<std::is_same<Result, void>::value == false>
     >
-    static std::shared_ptr < UnitBase > make_unit(const Result& expected, Result(*callable)(Args...), Args&&... args)
+    static std::shared_ptr < UnitBase > make_unit(Expected&& expected, Result(*callable)(Args...), Params&&... args)
     {
-        return std::make_shared < Unit < Result > >(expected, callable, std::forward<Args>(args)...);
+        return std::make_shared < Unit < Result > >(std::forward<Expected>(expected), callable, std::forward<Params>(args)...);
     }
     
     /** @brief Creates a new Unit with a non-void returning function, an expected result and a compareason function. */
     template < template < typename R > class Com,
+        typename Expected,
         typename Result,
         typename... Args,
+        typename... Params,
         typename = std::enable_if_t<std::is_same<Result, void>::value == false>
     >
-    static std::shared_ptr < UnitBase > make_unit(const Result& expected, Result(*callable)(Args...), Args&&... args)
+    static std::shared_ptr < UnitBase > make_unit(Expected&& expected, Result(*callable)(Args...), Params&&... args)
     {
-        return std::make_shared < Unit < Result, Com > >(expected, callable, std::forward<Args>(args)...);
+        return std::make_shared < Unit < Result, Com > >(std::forward<Expected>(expected), callable, std::forward<Params>(args)...);
     }
     
     /** @brief Creates a new Unit with a void returning function. */
     template < typename Result,
         typename... Args,
+        typename... Params,
         typename = std::enable_if_t<std::is_same<Result, void>::value>
     >
-    static std::shared_ptr < UnitBase > make_unit(Result(*callable)(Args...), Args&&... args)
+    static std::shared_ptr < UnitBase > make_unit(Result(*callable)(Args...), Params&&... args)
     {
-        return std::make_shared < Unit < Result > >(callable, std::forward<Args>(args)...);
+        return std::make_shared < Unit < Result > >(callable, std::forward<Params>(args)...);
     }
 }
 
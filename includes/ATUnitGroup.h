@@ -10,6 +10,8 @@
 #define ATUnitGroup_h
 
 #include "ATUnit.h"
+#include "ATShard.h"
+#include "ATFixture.h"
 
 namespace ATest
 {
@@ -27,17 +29,147 @@ namespace ATest
         
         std::atomic < bool > m_should_break_on_error;
         
+        //! @brief The Context given to this group with 'attach'.
+        Context m_context;
+        
+        //! @brief The path of this group: the scope of its Context joined with its name.
+        std::string m_path;
+        
+        //! @brief The part of the subunits runned by this group.
+        Shard m_shard;
+        
+        //! @brief The fixtures retained by this group while it runs.
+        std::vector < std::shared_ptr < FixtureBase > > m_fixtures;
+        
+        //! @brief The number of threads running the subunits.
+        size_t m_workers = 1;
+        
+        //! @brief True when subunits were left unrunned because of a cancellation.
+        std::atomic < bool > m_interrupted;
+        
+        //! @brief True if the Cancellation of \ref m_context was created by this group or given with
+        //! 'setCancellation', false if it was given by a parent group.
+        bool m_owns_cancellation;
+        
+        //! @brief The Cancellations given to each subgroup when this group doesn't break on error, reset when it runs.
+        std::vector < std::shared_ptr < Cancellation > > m_subunit_cancellations;
+        
+        //! @brief Protects the error when the subunits run on several workers.
+        std::mutex m_error_mutex;
+        
+        using Entry = std::pair < const std::shared_ptr < UnitBase >, Error >;
+        
+        /** @brief Returns the Context given to the fixtures. */
+        Context subcontext() const;
+        
+        /** @brief Returns the Context given to a subunit, with its own Cancellation if it is a subgroup and this
+         *  group doesn't break on error. */
+        Context subcontext(const UnitBase& subunit);
+        
+        /** @brief Returns the subunits to run, in the order they should run.
+         *
+         *  Only the subunits of \ref m_shard are returned. With a History, subunits that failed recently come
+         *  first, then the subunits unknown to the History, and each of those tiers is sorted from the longest
+         *  subunit to the shortest.
+         */
+        std::vector < Entry* > schedule();
+        
+        /** @brief Runs the subunits in the order given by 'schedule', on \ref m_workers threads. */
+        void run_scheduled();
+        
+        /** @brief Returns true if the Cancellation of this group is cancelled. */
+        bool isCancelled() const;
+        
+        /** @brief Runs the scheduled subunits from 'next' until all are runned or the run is cancelled. */
+        void run_worker(const std::vector < Entry* >& schedule, std::atomic < size_t >& next);
+        
+        /** @brief Runs one scheduled subunit and records its failure. */
+        void run_entry(Entry& entry);
+        
+        /** @brief Records the failure of a subunit, and cancels the run if this group breaks on error. */
+        void fail(Entry& entry, const Error& error);
+        
+        /** @brief Runs one subunit, reports its result if a Reporter is attached and samples it if a Profiler is
+         *  attached. */
+        bool run_subunit(const std::shared_ptr < UnitBase >& subunit);
+        
     public:
         
         UnitGroup();
         
         ~UnitGroup() = default;
         
+        /** @brief Adds a subunit. If the subunit has no name, it is named after its index in this group. */
         void addUnit(const std::shared_ptr < UnitBase >& subunit);
         
+        /** @brief Adds a fixture shared by the subunits.
+         *
+         *  The fixture is retained while this group runs: it is set up by the first subunit using it and torn down
+         *  when the group (and every other group holding it) has finished.
+         */
+        void addFixture(const std::shared_ptr < FixtureBase >& fixture);
+        
+        /** @brief Runs all subunits. If a Reporter is attached, each subunit is timed and reported.
+         *
+         *  If the run is cancelled before all subunits are runned, and no subunit of this group failed, the error
+         *  of the group is ECancelled.
+         */
         bool run();
         
         Error error() const;
+        
+        /** @brief Returns true: a group runs its subunits. */
+        bool holdsSubunits() const;
+        
+        /** @brief Keeps the Context and attaches it, scoped by the name of this group, to all subunits. */
+        void attach(const Context& context);
+        
+        /** @brief Attaches a Reporter to this group and all its subunits. */
+        void setReporter(const std::shared_ptr < Reporter >& reporter);
+        
+        /** @brief Attaches the History of the previous runs to this group and all its subunits. */
+        void setHistory(const std::shared_ptr < const History >& history);
+        
+        /** @brief Attaches a Profiler sampling the units of this group and of all its subgroups.
+         *
+         *  Each unit that is not a UnitGroup is sampled while it runs. Call Profiler::write() once the group has
+         *  runned to write the folded stacks.
+         */
+        void setProfiler(const std::shared_ptr < Profiler >& profiler);
+        
+        /** @brief Only runs the subunits of this group belonging to the given shard.
+         *
+         *  The subunits (not their own subunits) are partitioned with partition(), using the attached History to
+         *  balance the shards. Subunits of other shards are neither runned nor reported.
+         */
+        void setShard(const Shard& shard);
+        
+        /** @brief Sets the number of threads running the subunits of this group. 1 runs them on the calling thread.
+         *
+         *  Workers take the next subunit of the schedule as soon as they are free, thus long subunits scheduled
+         *  first (with a History) keep all workers busy until the end.
+         */
+        void setWorkers(size_t workers);
+        
+        /** @brief If true (the default), the first failed subunit stops the run: this group cancels its
+         *  Cancellation, thus neither this group nor any group sharing it (its subgroups on every worker, and its
+         *  parent if the parent breaks on error too) start other subunits.
+         *
+         *  If false, each subgroup is given its own Cancellation: a subgroup breaking on error only stops itself.
+         */
+        void setBreakOnError(bool should_break);
+        
+        /** @brief Attaches a Cancellation shared with this group and its subunits, in place of its own one.
+         *
+         *  Share the same Cancellation between groups runned from different UnitThreads to stop all of them on the
+         *  first failure. A null Cancellation gives this group a new one of its own.
+         *
+         *  @note
+         *  Only a root group keeps this Cancellation: adding the group to another one (or attaching the parent
+         *  again, with setReporter() for example) replaces it with the Cancellation of the parent. Set it on the
+         *  root of each tree instead.
+         */
+        void setCancellation(const std::shared_ptr < Cancellation >& cancellation);
     };
 }
 
@@ -69,12 +69,18 @@ namespace ATest
         /** @brief Returns the current error. */
         Error error() const;
         
+        /** @brief Returns true: a UnitThread runs the units of its group. */
+        bool holdsSubunits() const;
+        
         /** @brief Returns true if this UnitThread is running. */
         bool isRunning() const;
         
         /** @brief Adds a unit to the UnitGroup of this unit. */
         void addUnit(const std::shared_ptr < UnitBase >& unit);
         
+        /** @brief Attaches the Context to the UnitGroup of this unit. */
+        void attach(const Context& context);
+        
         /** @brief Waits for \ref m_running_thread to finish and returns the value of \ref m_is_running. */
         bool wait();
     };
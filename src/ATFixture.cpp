@@ -0,0 +1,171 @@
+//
+//  ATFixture.cpp
+//  ATest
+//
+//  Created by jacques tronconi on 19/10/2026.
+//
+
+#include "ATFixture.h"
+
+namespace ATest
+{
+    namespace
+    {
+        //! @brief The time spent setting up fixtures on this thread, in nanoseconds.
+        thread_local std::chrono::nanoseconds::rep t_setup_time = 0;
+
+        /** @brief Adds the time from its construction to its destruction to the set up time of the thread. */
+        class SetupTimer
+        {
+            std::chrono::steady_clock::time_point m_start;
+
+        public:
+            SetupTimer(): m_start(std::chrono::steady_clock::now())
+            {
+
+            }
+
+            ~SetupTimer()
+            {
+                t_setup_time += std::chrono::duration_cast < std::chrono::nanoseconds >(
+                    std::chrono::steady_clock::now() - m_start).count();
+            }
+        };
+
+        /** @brief Returns the message of an exception. */
+        std::string exception_message(const std::exception_ptr& exception)
+        {
+            try
+            {
+                std::rethrow_exception(exception);
+            }
+
+            catch(const std::exception& e)
+            {
+                return e.what();
+            }
+
+            catch(...)
+            {
+                return "Unknown exception.";
+            }
+        }
+    }
+
+    FixtureBase::FixtureBase(const std::string& name)
+    : m_name(name), m_instance(nullptr), m_setup_time(std::chrono::nanoseconds::zero())
+    {
+
+    }
+
+    const void* FixtureBase::acquire()
+    {
+        const void* instance = m_instance.load(std::memory_order_acquire);
+
+        if (instance)
+            return instance;
+
+        // Every thread taking the slow path spends its time on the fixture, either setting it up or waiting for
+        // another thread to set it up: it is counted as set up time on each of them, not in their units.
+        SetupTimer timer;
+        std::lock_guard < std::mutex > lock(m_mutex);
+        instance = m_instance.load(std::memory_order_relaxed);
+
+        if (instance)
+            return instance;
+
+        if (m_setup_error)
+            std::rethrow_exception(m_setup_error);
+
+        auto start = std::chrono::steady_clock::now();
+
+        try
+        {
+            instance = setup();
+        }
+
+        catch(...)
+        {
+            m_setup_error = std::current_exception();
+        }
+
+        m_setup_time = std::chrono::duration_cast < std::chrono::nanoseconds >(std::chrono::steady_clock::now() - start);
+
+        if (m_context.reporter)
+        {
+            Report report;
+            report.path = join_path(m_context.scope, m_name);
+            report.id = unit_id(report.path);
+            report.kind = EFixtureReport;
+            report.duration = m_setup_time;
+
+            if (m_setup_error)
+                report.error = Error(EReturnedError, exception_message(m_setup_error));
+
+            m_context.reporter->report(report);
+        }
+
+        if (m_setup_error)
+            std::rethrow_exception(m_setup_error);
+
+        m_instance.store(instance, std::memory_order_release);
+        return instance;
+    }
+
+    void FixtureBase::destroy_locked()
+    {
+        const void* instance = m_instance.exchange(nullptr);
+
+        if (instance)
+            teardown(instance);
+
+        m_setup_error = nullptr;
+    }
+
+    void FixtureBase::destroy()
+    {
+        std::lock_guard < std::mutex > lock(m_mutex);
+        destroy_locked();
+    }
+
+    const std::string& FixtureBase::name() const
+    {
+        return m_name;
+    }
+
+    void FixtureBase::retain()
+    {
+        std::lock_guard < std::mutex > lock(m_mutex);
+        m_users++;
+    }
+
+    void FixtureBase::release()
+    {
+        std::lock_guard < std::mutex > lock(m_mutex);
+
+        if (m_users > 0 && --m_users == 0)
+            destroy_locked();
+    }
+
+    bool FixtureBase::isReady() const
+    {
+        return m_instance.load(std::memory_order_acquire) != nullptr;
+    }
+
+    std::chrono::nanoseconds FixtureBase::setupTime() const
+    {
+        std::lock_guard < std::mutex > lock(m_mutex);
+        return m_setup_time;
+    }
+
+    void FixtureBase::attach(const Context& context)
+    {
+        std::lock_guard < std::mutex > lock(m_mutex);
+        m_context = context;
+    }
+
+    std::chrono::nanoseconds FixtureBase::threadSetupTime()
+    {
+        return std::chrono::nanoseconds(t_setup_time);
+    }
+}
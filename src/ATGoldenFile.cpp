@@ -0,0 +1,95 @@
+//
+//  ATGoldenFile.cpp
+//  ATest
+//
+//  Created by jacques tronconi on 19/10/2026.
+//
+
+#include "ATGoldenFile.h"
+
+#include <cerrno>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace ATest
+{
+    GoldenFile::GoldenFile(const std::string& path)
+    {
+        int file = ::open(path.c_str(), O_RDONLY);
+
+        if (file < 0)
+            throw Error(EFileError, "Cannot open golden file '" + path + "': " + std::strerror(errno));
+
+        struct stat status;
+
+        if (::fstat(file, &status) != 0)
+        {
+            ::close(file);
+            throw Error(EFileError, "Cannot stat golden file '" + path + "': " + std::strerror(errno));
+        }
+
+        m_size = static_cast < size_t >(status.st_size);
+
+        if (m_size > 0)
+        {
+            void* data = ::mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, file, 0);
+
+            if (data == MAP_FAILED)
+            {
+                ::close(file);
+                throw Error(EFileError, "Cannot map golden file '" + path + "': " + std::strerror(errno));
+            }
+
+            // The comparison reads the file once from the beginning to the end.
+            ::madvise(data, m_size, MADV_SEQUENTIAL);
+            m_data = static_cast < const char* >(data);
+        }
+
+        ::close(file);
+    }
+
+    GoldenFile::~GoldenFile()
+    {
+        if (m_data)
+            ::munmap(const_cast < char* >(m_data), m_size);
+    }
+
+    const void* GoldenFile::data() const
+    {
+        return m_data;
+    }
+
+    size_t GoldenFile::size() const
+    {
+        return m_size;
+    }
+
+    size_t GoldenFile::compare(const void* data, size_t size) const
+    {
+        size_t common = std::min(size, m_size);
+        const char* bytes = static_cast < const char* >(data);
+
+        // Compares large blocks with memcmp, and only searches the exact byte inside the block that differs.
+        const size_t block = 1 << 16;
+
+        for (size_t offset = 0; offset < common; offset += block)
+        {
+            size_t length = std::min(block, common - offset);
+
+            if (std::memcmp(bytes + offset, m_data + offset, length) == 0)
+                continue;
+
+            for (size_t i = offset; i < offset + length; ++i)
+            {
+                if (bytes[i] != m_data[i])
+                    return i;
+            }
+        }
+
+        return size == m_size ? npos : common;
+    }
+}
@@ -0,0 +1,134 @@
+//
+//  ATHistory.cpp
+//  ATest
+//
+//  Created by jacques tronconi on 19/10/2026.
+//
+
+#include "ATHistory.h"
+
+#include <cinttypes>
+#include <cstdio>
+
+namespace ATest
+{
+    namespace
+    {
+        //! @brief The first word of each history file.
+        constexpr const char* kHistoryMagic = "atest-history";
+
+        //! @brief The version of the history format.
+        constexpr int kHistoryVersion = 1;
+    }
+
+    History History::load(const std::string& path)
+    {
+        History history;
+        std::FILE* file = std::fopen(path.c_str(), "r");
+
+        if (!file)
+            return history;
+
+        char magic[32] = {};
+        int version = 0;
+        uint64_t generation = 0;
+
+        if (std::fscanf(file, "%31s %d %" SCNu64, magic, &version, &generation) != 3
+            || std::string(magic) != kHistoryMagic || version != kHistoryVersion)
+        {
+            std::fclose(file);
+            throw Error(EInvalidFormat, "'" + path + "' is not a history file.");
+        }
+
+        history.m_generation = generation;
+
+        uint64_t id = 0;
+        HistoryEntry entry;
+        int read = 0;
+
+        while ((read = std::fscanf(file, "%" SCNx64 " %" SCNd64 " %" SCNu32 " %" SCNu32 " %" SCNu64,
+                                   &id, &entry.duration, &entry.runs, &entry.failures, &entry.last_failure)) == 5)
+        {
+            history.m_entries[id] = entry;
+        }
+
+        bool complete = read == EOF;
+        std::fclose(file);
+
+        if (!complete)
+            throw Error(EInvalidFormat, "'" + path + "' is not a valid history file.");
+
+        return history;
+    }
+
+    void History::save(const std::string& path) const
+    {
+        std::FILE* file = std::fopen(path.c_str(), "w");
+
+        if (!file)
+            throw Error(EFileError, "Cannot open history file '" + path + "'.");
+
+        std::fprintf(file, "%s %d %" PRIu64 "\n", kHistoryMagic, kHistoryVersion, m_generation);
+
+        for (const auto& entry : m_entries)
+        {
+            std::fprintf(file, "%016" PRIx64 " %" PRId64 " %" PRIu32 " %" PRIu32 " %" PRIu64 "\n",
+                         entry.first, entry.second.duration, entry.second.runs, entry.second.failures,
+                         entry.second.last_failure);
+        }
+
+        bool failed = std::ferror(file) != 0;
+
+        if (std::fclose(file) != 0 || failed)
+            throw Error(EFileError, "Cannot write history file '" + path + "'.");
+    }
+
+    void History::record(const ResultLog& log)
+    {
+        record(std::vector < const ResultLog* > { &log });
+    }
+
+    void History::record(const std::vector < const ResultLog* >& logs)
+    {
+        m_generation++;
+
+        for (const ResultLog* log : logs)
+        {
+            for (const ResultRecord& record : *log)
+            {
+                // A cancelled group neither failed nor ran in full: its record says nothing about the group.
+                if (record.cancelled())
+                    continue;
+
+                HistoryEntry& entry = m_entries[record.id];
+
+                // Weights the last run as much as all the previous ones, so the estimate follows a unit that
+                // becomes slower in a couple of runs but one noisy run doesn't replace it.
+                entry.duration = entry.runs == 0 ? record.duration : (entry.duration + record.duration) / 2;
+                entry.runs++;
+
+                if (record.failed())
+                {
+                    entry.failures++;
+                    entry.last_failure = m_generation;
+                }
+            }
+        }
+    }
+
+    const HistoryEntry* History::find(uint64_t id) const
+    {
+        auto it = m_entries.find(id);
+        return it == m_entries.end() ? nullptr : &it->second;
+    }
+
+    uint64_t History::generation() const
+    {
+        return m_generation;
+    }
+
+    size_t History::size() const
+    {
+        return m_entries.size();
+    }
+}
@@ -0,0 +1,466 @@
+//
+//  ATProfiler.cpp
+//  ATest
+//
+//  Created by jacques tronconi on 19/10/2026.
+//
+
+#include "ATProfiler.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include <cxxabi.h>
+#include <dlfcn.h>
+#include <execinfo.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <ucontext.h>
+#include <unistd.h>
+#endif
+
+// Walks the frame pointers from the interrupted context where their layout is known. Elsewhere, backtrace() is
+// used even though it isn't async-signal-safe (see the note of Profiler).
+#if defined(__linux__) && (defined(__x86_64__) || defined(__aarch64__))
+#define ATEST_PROFILER_FRAME_POINTERS 1
+#else
+#define ATEST_PROFILER_FRAME_POINTERS 0
+#endif
+
+namespace ATest
+{
+    namespace
+    {
+        //! @brief The maximum depth of a sampled stack.
+        constexpr int kMaxDepth = 64;
+
+        //! @brief The frames of the signal handler at the top of each sampled stack: the handler itself and the
+        //! signal trampoline when using backtrace(). The frame pointer walk starts at the interrupted instruction.
+        constexpr int kHandlerFrames = ATEST_PROFILER_FRAME_POINTERS ? 0 : 2;
+
+        /** @brief The samples of the unit running on one thread.
+         *
+         *  The buffer is only written by the signal handler of its own thread, and only read by this thread once the
+         *  timer is stopped, thus the slot reservation is the only synchronization needed.
+         */
+        struct SampleBuffer
+        {
+            struct Sample
+            {
+                int depth;
+                void* frames[kMaxDepth];
+            };
+
+            std::vector < Sample > samples;
+            std::atomic < size_t > count;
+
+            SampleBuffer(): count(0)
+            {
+
+            }
+        };
+
+        //! @brief The buffer of the unit being sampled on this thread, or null when the thread isn't sampled.
+        thread_local SampleBuffer* volatile t_active_buffer = nullptr;
+
+#if defined(__linux__)
+        //! @brief The timer of this thread.
+        thread_local timer_t t_timer;
+#else
+        //! @brief The number of threads being sampled, using the process-wide timer.
+        std::atomic < int > g_sampled_threads(0);
+#endif
+
+#if ATEST_PROFILER_FRAME_POINTERS
+        //! @brief The bounds of the stack of this thread, read by 'begin' as the handler cannot read them.
+        thread_local uintptr_t t_stack_low = 0;
+        thread_local uintptr_t t_stack_high = 0;
+
+        /** @brief Reads the bounds of the stack of the calling thread. */
+        void read_stack_bounds()
+        {
+            pthread_attr_t attributes;
+
+            if (::pthread_getattr_np(::pthread_self(), &attributes) != 0)
+                return;
+
+            void* address = nullptr;
+            size_t size = 0;
+
+            if (::pthread_attr_getstack(&attributes, &address, &size) == 0)
+            {
+                t_stack_low = reinterpret_cast < uintptr_t >(address);
+                t_stack_high = t_stack_low + size;
+            }
+
+            ::pthread_attr_destroy(&attributes);
+        }
+
+        /** @brief Stores the stack of the interrupted code into 'frames' by following its frame pointers.
+         *
+         *  Each frame record is the saved frame pointer followed by the return address. Every record is checked to
+         *  lie in the stack of the thread, above the previous one, thus code without frame pointers only truncates
+         *  the stack (or adds frames read from the stack) but never makes the walk read outside of it.
+         */
+        int walk_frames(void* context, void** frames)
+        {
+            const ucontext_t* interrupted = static_cast < const ucontext_t* >(context);
+
+#if defined(__x86_64__)
+            uintptr_t pc = static_cast < uintptr_t >(interrupted->uc_mcontext.gregs[REG_RIP]);
+            uintptr_t fp = static_cast < uintptr_t >(interrupted->uc_mcontext.gregs[REG_RBP]);
+#else
+            uintptr_t pc = static_cast < uintptr_t >(interrupted->uc_mcontext.pc);
+            uintptr_t fp = static_cast < uintptr_t >(interrupted->uc_mcontext.regs[29]);
+#endif
+
+            int depth = 0;
+            frames[depth++] = reinterpret_cast < void* >(pc);
+
+            while (depth < kMaxDepth)
+            {
+                if (fp < t_stack_low || fp > t_stack_high - 2 * sizeof(uintptr_t) || fp % sizeof(uintptr_t))
+                    break;
+
+                const uintptr_t* record = reinterpret_cast < const uintptr_t* >(fp);
+                uintptr_t next = record[0];
+                uintptr_t return_address = record[1];
+
+                if (!return_address)
+                    break;
+
+                frames[depth++] = reinterpret_cast < void* >(return_address);
+
+                if (next <= fp)
+                    break;
+
+                fp = next;
+            }
+
+            return depth;
+        }
+#endif
+
+        void on_sigprof(int, siginfo_t*, void* context)
+        {
+            SampleBuffer* buffer = t_active_buffer;
+
+            if (!buffer)
+                return;
+
+            int saved_errno = errno;
+            size_t index = buffer->count.fetch_add(1, std::memory_order_relaxed);
+
+            if (index < buffer->samples.size())
+            {
+                SampleBuffer::Sample& sample = buffer->samples[index];
+
+#if ATEST_PROFILER_FRAME_POINTERS
+                sample.depth = walk_frames(context, sample.frames);
+#else
+                (void)context;
+                sample.depth = ::backtrace(sample.frames, kMaxDepth);
+#endif
+            }
+
+            errno = saved_errno;
+        }
+
+        /** @brief Installs the SIGPROF handler, once for the process. */
+        bool install_handler()
+        {
+            static bool installed = [](){
+#if !ATEST_PROFILER_FRAME_POINTERS
+                // The first call to backtrace() loads the unwinder, which allocates: do it out of the handler.
+                void* frames[1];
+                ::backtrace(frames, 1);
+#endif
+
+                struct sigaction action;
+                std::memset(&action, 0, sizeof(action));
+                action.sa_sigaction = on_sigprof;
+                action.sa_flags = SA_SIGINFO | SA_RESTART;
+                sigemptyset(&action.sa_mask);
+
+                return ::sigaction(SIGPROF, &action, nullptr) == 0;
+            }();
+
+            return installed;
+        }
+
+        /** @brief Returns the buffer of the calling thread. */
+        SampleBuffer& thread_buffer()
+        {
+            static thread_local SampleBuffer buffer;
+            return buffer;
+        }
+
+        /** @brief Starts the timer sampling the calling thread. */
+        bool start_timer(unsigned frequency)
+        {
+            long interval = 1000000000L / static_cast < long >(frequency ? frequency : 1);
+
+#if defined(__linux__)
+            struct sigevent event;
+            std::memset(&event, 0, sizeof(event));
+            event.sigev_notify = SIGEV_THREAD_ID;
+            event.sigev_signo = SIGPROF;
+#if defined(sigev_notify_thread_id)
+            event.sigev_notify_thread_id = static_cast < pid_t >(::syscall(SYS_gettid));
+#else
+            event._sigev_un._tid = static_cast < pid_t >(::syscall(SYS_gettid));
+#endif
+
+            if (::timer_create(CLOCK_THREAD_CPUTIME_ID, &event, &t_timer) != 0)
+                return false;
+
+            struct itimerspec spec;
+            spec.it_interval.tv_sec = interval / 1000000000L;
+            spec.it_interval.tv_nsec = interval % 1000000000L;
+            spec.it_value = spec.it_interval;
+
+            if (::timer_settime(t_timer, 0, &spec, nullptr) != 0)
+            {
+                ::timer_delete(t_timer);
+                return false;
+            }
+
+            return true;
+#else
+            if (g_sampled_threads.fetch_add(1) > 0)
+                return true;
+
+            struct itimerval spec;
+            spec.it_interval.tv_sec = interval / 1000000000L;
+            spec.it_interval.tv_usec = (interval % 1000000000L) / 1000;
+            spec.it_value = spec.it_interval;
+
+            if (::setitimer(ITIMER_PROF, &spec, nullptr) != 0)
+            {
+                g_sampled_threads--;
+                return false;
+            }
+
+            return true;
+#endif
+        }
+
+        /** @brief Stops the timer started by start_timer(). */
+        void stop_timer()
+        {
+#if defined(__linux__)
+            ::timer_delete(t_timer);
+#else
+            if (g_sampled_threads.fetch_sub(1) == 1)
+            {
+                struct itimerval spec;
+                std::memset(&spec, 0, sizeof(spec));
+                ::setitimer(ITIMER_PROF, &spec, nullptr);
+            }
+#endif
+        }
+
+        /** @brief Returns a file name made from the path of a unit. */
+        std::string file_name(const std::string& path)
+        {
+            std::string name = path.empty() ? "unit" : path;
+
+            for (char& c : name)
+            {
+                bool allowed = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9')
+                    || c == '-' || c == '_' || c == '.';
+
+                if (!allowed)
+                    c = '_';
+            }
+
+            return name + ".folded";
+        }
+
+        /** @brief Writes folded stacks to a file, each stack prefixed by 'prefix'. */
+        void write_folded(std::FILE* file, const std::string& prefix, const std::map < std::string, size_t >& stacks)
+        {
+            for (const auto& stack : stacks)
+                std::fprintf(file, "%s%s %zu\n", prefix.c_str(), stack.first.c_str(), stack.second);
+        }
+    }
+
+    Profiler::Profiler(const std::string& directory, unsigned frequency, size_t max_samples)
+    : m_directory(directory), m_frequency(frequency), m_max_samples(max_samples)
+    {
+
+    }
+
+    bool Profiler::begin()
+    {
+        // The thread is already sampled for an enclosing unit: its timer and buffer belong to that unit.
+        if (t_active_buffer || !install_handler())
+            return false;
+
+        SampleBuffer& buffer = thread_buffer();
+
+        if (buffer.samples.size() != m_max_samples)
+            buffer.samples.resize(m_max_samples);
+
+#if ATEST_PROFILER_FRAME_POINTERS
+        if (t_stack_high == 0)
+            read_stack_bounds();
+#endif
+
+        buffer.count.store(0, std::memory_order_relaxed);
+        std::atomic_signal_fence(std::memory_order_seq_cst);
+
+        t_active_buffer = &buffer;
+
+        if (!start_timer(m_frequency))
+        {
+            t_active_buffer = nullptr;
+            return false;
+        }
+
+        return true;
+    }
+
+    void Profiler::end(const std::string& path)
+    {
+        SampleBuffer* buffer = t_active_buffer;
+
+        if (!buffer)
+            return;
+
+        // Detaches the buffer before stopping the timer: a signal still pending is then ignored.
+        t_active_buffer = nullptr;
+        std::atomic_signal_fence(std::memory_order_seq_cst);
+        stop_timer();
+
+        size_t count = buffer->count.load(std::memory_order_relaxed);
+        size_t kept = std::min(count, buffer->samples.size());
+
+        std::lock_guard < std::mutex > lock(m_mutex);
+        std::map < std::string, size_t >& profile = m_profiles[path];
+        m_dropped += count - kept;
+
+        for (size_t i = 0; i < kept; ++i)
+        {
+            const SampleBuffer::Sample& sample = buffer->samples[i];
+            std::string folded;
+
+            for (int frame = sample.depth - 1; frame >= kHandlerFrames; --frame)
+            {
+                if (!folded.empty())
+                    folded += ';';
+
+                folded += symbol(sample.frames[frame]);
+            }
+
+            if (!folded.empty())
+                profile[folded]++;
+        }
+    }
+
+    const std::string& Profiler::symbol(void* address)
+    {
+        auto it = m_symbols.find(address);
+
+        if (it != m_symbols.end())
+            return it->second;
+
+        std::string name;
+        Dl_info info;
+
+        if (::dladdr(address, &info) && info.dli_sname)
+        {
+            int status = 0;
+            char* demangled = abi::__cxa_demangle(info.dli_sname, nullptr, nullptr, &status);
+            name = status == 0 && demangled ? demangled : info.dli_sname;
+            std::free(demangled);
+        }
+
+        else if (::dladdr(address, &info) && info.dli_fname)
+        {
+            // No symbol (a static function of a stripped library): names the frame after its module.
+            const char* module = std::strrchr(info.dli_fname, '/');
+            char text[32];
+            std::snprintf(text, sizeof(text), "+0x%zx", static_cast < size_t >(
+                static_cast < char* >(address) - static_cast < char* >(info.dli_fbase)));
+            name = std::string(module ? module + 1 : info.dli_fname) + text;
+        }
+
+        else
+        {
+            char text[32];
+            std::snprintf(text, sizeof(text), "%p", address);
+            name = text;
+        }
+
+        // ';' separates the frames of a folded stack, and ' ' separates the stack from its count.
+        for (char& c : name)
+        {
+            if (c == ';')
+                c = ',';
+            else if (c == '\n')
+                c = ' ';
+        }
+
+        return m_symbols.emplace(address, name).first->second;
+    }
+
+    std::map < std::string, size_t > Profiler::profile(const std::string& path) const
+    {
+        std::lock_guard < std::mutex > lock(m_mutex);
+        auto it = m_profiles.find(path);
+
+        return it == m_profiles.end() ? std::map < std::string, size_t >() : it->second;
+    }
+
+    size_t Profiler::dropped() const
+    {
+        std::lock_guard < std::mutex > lock(m_mutex);
+        return m_dropped;
+    }
+
+    void Profiler::write() const
+    {
+        std::lock_guard < std::mutex > lock(m_mutex);
+
+        if (::mkdir(m_directory.c_str(), 0755) != 0 && errno != EEXIST)
+            throw Error(EFileError, "Cannot create profile directory '" + m_directory + "': " + std::strerror(errno));
+
+        std::string all_path = m_directory + "/all.folded";
+        std::FILE* all = std::fopen(all_path.c_str(), "w");
+
+        if (!all)
+            throw Error(EFileError, "Cannot open '" + all_path + "': " + std::strerror(errno));
+
+        for (const auto& profile : m_profiles)
+        {
+            std::string unit_path = m_directory + "/" + file_name(profile.first);
+            std::FILE* file = std::fopen(unit_path.c_str(), "w");
+
+            if (!file)
+            {
+                std::fclose(all);
+                throw Error(EFileError, "Cannot open '" + unit_path + "': " + std::strerror(errno));
+            }
+
+            write_folded(file, "", profile.second);
+            std::fclose(file);
+
+            std::string root = profile.first;
+            std::replace(root.begin(), root.end(), ';', ',');
+            write_folded(all, root + ";", profile.second);
+        }
+
+        if (std::fclose(all) != 0)
+            throw Error(EFileError, "Cannot write '" + all_path + "'.");
+    }
+}
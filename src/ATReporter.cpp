@@ -0,0 +1,35 @@
+//
+//  ATReporter.cpp
+//  ATest
+//
+//  Created by jacques tronconi on 19/10/2026.
+//
+
+#include "ATReporter.h"
+
+namespace ATest
+{
+    uint64_t unit_id(const std::string& path)
+    {
+        uint64_t hash = 14695981039346656037ull;
+
+        for (unsigned char c : path)
+        {
+            hash ^= c;
+            hash *= 1099511628211ull;
+        }
+
+        return hash;
+    }
+
+    std::string join_path(const std::string& scope, const std::string& name)
+    {
+        if (scope.empty())
+            return name;
+
+        if (name.empty())
+            return scope;
+
+        return scope + "/" + name;
+    }
+}
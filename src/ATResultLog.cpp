@@ -0,0 +1,490 @@
+//
+//  ATResultLog.cpp
+//  ATest
+//
+//  Created by jacques tronconi on 19/10/2026.
+//
+
+#include "ATResultLog.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <queue>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace ATest
+{
+    namespace
+    {
+        //! @brief The size of the buffer of ResultLogWriter.
+        constexpr size_t kWriteBufferSize = 1 << 20;
+
+        //! @brief The magic starting each log.
+        constexpr char kHeaderMagic[8] = { 'A', 'T', 'R', 'L', 'O', 'G', '\0', '\1' };
+
+        //! @brief The magic ending each complete log.
+        constexpr char kFooterMagic[8] = { 'A', 'T', 'R', 'E', 'N', 'D', '\0', '\1' };
+
+        //! @brief The version of the log format.
+        constexpr uint32_t kVersion = 1;
+
+        struct LogHeader
+        {
+            char magic[8];
+            uint32_t version;
+            uint32_t record_size;
+            uint64_t reserved[2];
+        };
+
+        struct LogFooter
+        {
+            uint64_t strings_offset;
+            uint64_t strings_size;
+            uint64_t count;
+            char magic[8];
+        };
+
+        static_assert(sizeof(LogHeader) == 32, "LogHeader must stay 32 bytes long.");
+        static_assert(sizeof(LogFooter) == 32, "LogFooter must stay 32 bytes long.");
+
+        /** @brief Writes all the bytes to the file, or throws an Error. */
+        void write_all(int file, const char* data, size_t size)
+        {
+            while (size > 0)
+            {
+                ssize_t written = ::write(file, data, size);
+
+                if (written < 0)
+                {
+                    if (errno == EINTR)
+                        continue;
+
+                    throw Error(EFileError, std::string("Cannot write result log: ") + std::strerror(errno));
+                }
+
+                data += written;
+                size -= static_cast < size_t >(written);
+            }
+        }
+    }
+
+    ResultLogWriter::ResultLogWriter(const std::string& path)
+    {
+        m_file = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+
+        if (m_file < 0)
+            throw Error(EFileError, "Cannot open result log '" + path + "': " + std::strerror(errno));
+
+        m_buffer.reserve(kWriteBufferSize);
+        m_strings.push_back('\0');
+
+        LogHeader header = {};
+        std::memcpy(header.magic, kHeaderMagic, sizeof(header.magic));
+        header.version = kVersion;
+        header.record_size = sizeof(ResultRecord);
+
+        const char* bytes = reinterpret_cast < const char* >(&header);
+        m_buffer.insert(m_buffer.end(), bytes, bytes + sizeof(header));
+    }
+
+    ResultLogWriter::~ResultLogWriter()
+    {
+        try
+        {
+            close();
+        }
+
+        catch(const std::exception&)
+        {
+
+        }
+    }
+
+    uint32_t ResultLogWriter::intern(const std::string& string)
+    {
+        if (string.empty())
+            return 0;
+
+        if ((m_string_count + 1) * 2 > m_string_slots.size())
+        {
+            std::vector < std::pair < uint32_t, uint32_t > > slots(std::max < size_t >(1024, m_string_slots.size() * 2));
+
+            for (const auto& slot : m_string_slots)
+            {
+                if (slot.first == 0)
+                    continue;
+
+                size_t index = slot.second & (slots.size() - 1);
+
+                while (slots[index].first != 0)
+                    index = (index + 1) & (slots.size() - 1);
+
+                slots[index] = slot;
+            }
+
+            m_string_slots.swap(slots);
+        }
+
+        uint32_t hash = static_cast < uint32_t >(unit_id(string));
+        size_t index = hash & (m_string_slots.size() - 1);
+
+        while (m_string_slots[index].first != 0)
+        {
+            const auto& slot = m_string_slots[index];
+
+            if (slot.second == hash
+                && m_strings.compare(slot.first, string.size(), string) == 0
+                && m_strings[slot.first + string.size()] == '\0')
+            {
+                return slot.first;
+            }
+
+            index = (index + 1) & (m_string_slots.size() - 1);
+        }
+
+        // Offsets are stored on 32 bits in the records.
+        if (m_strings.size() + string.size() + 1 > UINT32_MAX)
+            throw Error(EFileError, "The string table of the result log is larger than 4 GiB.");
+
+        uint32_t offset = static_cast < uint32_t >(m_strings.size());
+        m_strings.append(string.c_str(), string.size() + 1);
+        m_string_slots[index] = std::make_pair(offset, hash);
+        m_string_count++;
+
+        return offset;
+    }
+
+    void ResultLogWriter::flush()
+    {
+        write_all(m_file, m_buffer.data(), m_buffer.size());
+        m_buffer.clear();
+    }
+
+    void ResultLogWriter::report(const Report& report)
+    {
+        ResultRecord record = {};
+        record.id = report.id;
+        record.duration = report.duration.count();
+        record.code = static_cast < uint16_t >(report.error.code());
+        record.kind = static_cast < uint16_t >(report.kind);
+
+        append(record, report.path, report.error.code() == ENoError ? std::string() : std::string(report.error.what()));
+    }
+
+    void ResultLogWriter::append(const ResultRecord& record, const std::string& name, const std::string& message)
+    {
+        std::lock_guard < std::mutex > lock(m_mutex);
+
+        if (m_file < 0)
+            return;
+
+        ResultRecord stored = record;
+        stored.name = intern(name);
+        stored.message = intern(message);
+        stored.reserved = 0;
+
+        if (m_buffer.size() + sizeof(stored) > kWriteBufferSize)
+            flush();
+
+        const char* bytes = reinterpret_cast < const char* >(&stored);
+        m_buffer.insert(m_buffer.end(), bytes, bytes + sizeof(stored));
+        m_count++;
+    }
+
+    void ResultLogWriter::close()
+    {
+        std::lock_guard < std::mutex > lock(m_mutex);
+
+        if (m_file < 0)
+            return;
+
+        try
+        {
+            flush();
+            write_all(m_file, m_strings.data(), m_strings.size());
+
+            LogFooter footer = {};
+            footer.strings_offset = sizeof(LogHeader) + m_count * sizeof(ResultRecord);
+            footer.strings_size = m_strings.size();
+            footer.count = m_count;
+            std::memcpy(footer.magic, kFooterMagic, sizeof(footer.magic));
+
+            write_all(m_file, reinterpret_cast < const char* >(&footer), sizeof(footer));
+        }
+
+        catch(const Error&)
+        {
+            ::close(m_file);
+            m_file = -1;
+            throw;
+        }
+
+        int result = ::close(m_file);
+        m_file = -1;
+
+        if (result != 0)
+            throw Error(EFileError, std::string("Cannot close result log: ") + std::strerror(errno));
+    }
+
+    uint64_t ResultLogWriter::size() const
+    {
+        return m_count;
+    }
+
+    ResultLog::ResultLog(const std::string& path)
+    {
+        int file = ::open(path.c_str(), O_RDONLY);
+
+        if (file < 0)
+            throw Error(EFileError, "Cannot open result log '" + path + "': " + std::strerror(errno));
+
+        struct stat status;
+
+        if (::fstat(file, &status) != 0)
+        {
+            ::close(file);
+            throw Error(EFileError, "Cannot stat result log '" + path + "': " + std::strerror(errno));
+        }
+
+        size_t size = static_cast < size_t >(status.st_size);
+
+        if (size < sizeof(LogHeader) + sizeof(LogFooter))
+        {
+            ::close(file);
+            throw Error(EInvalidFormat, "'" + path + "' is not a complete result log.");
+        }
+
+        void* data = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, file, 0);
+        ::close(file);
+
+        if (data == MAP_FAILED)
+            throw Error(EFileError, "Cannot map result log '" + path + "': " + std::strerror(errno));
+
+        m_data = static_cast < const char* >(data);
+        m_size = size;
+
+        LogHeader header;
+        LogFooter footer;
+        std::memcpy(&header, m_data, sizeof(header));
+        std::memcpy(&footer, m_data + size - sizeof(footer), sizeof(footer));
+
+        bool valid = std::memcmp(header.magic, kHeaderMagic, sizeof(header.magic)) == 0
+            && header.version == kVersion
+            && header.record_size == sizeof(ResultRecord)
+            && std::memcmp(footer.magic, kFooterMagic, sizeof(footer.magic)) == 0
+            && footer.count <= (size - sizeof(LogHeader) - sizeof(LogFooter)) / sizeof(ResultRecord)
+            && footer.strings_offset == sizeof(LogHeader) + footer.count * sizeof(ResultRecord)
+            && footer.strings_size > 0
+            && footer.strings_size == size - sizeof(LogFooter) - footer.strings_offset
+            && m_data[footer.strings_offset + footer.strings_size - 1] == '\0';
+
+        if (!valid)
+        {
+            ::munmap(data, size);
+            m_data = nullptr;
+            m_size = 0;
+
+            throw Error(EInvalidFormat, "'" + path + "' is not a complete result log.");
+        }
+
+        m_records = reinterpret_cast < const ResultRecord* >(m_data + sizeof(LogHeader));
+        m_count = static_cast < size_t >(footer.count);
+        m_strings = m_data + footer.strings_offset;
+        m_strings_size = static_cast < size_t >(footer.strings_size);
+    }
+
+    ResultLog::~ResultLog()
+    {
+        if (m_data)
+            ::munmap(const_cast < char* >(m_data), m_size);
+    }
+
+    ResultLog::ResultLog(ResultLog&& rhs) noexcept
+    : m_data(rhs.m_data), m_size(rhs.m_size), m_records(rhs.m_records), m_count(rhs.m_count),
+    m_strings(rhs.m_strings), m_strings_size(rhs.m_strings_size)
+    {
+        rhs.m_data = nullptr;
+        rhs.m_size = 0;
+        rhs.m_records = nullptr;
+        rhs.m_count = 0;
+        rhs.m_strings = nullptr;
+        rhs.m_strings_size = 0;
+    }
+
+    ResultLog& ResultLog::operator=(ResultLog&& rhs) noexcept
+    {
+        if (this != &rhs)
+        {
+            if (m_data)
+                ::munmap(const_cast < char* >(m_data), m_size);
+
+            m_data = rhs.m_data;
+            m_size = rhs.m_size;
+            m_records = rhs.m_records;
+            m_count = rhs.m_count;
+            m_strings = rhs.m_strings;
+            m_strings_size = rhs.m_strings_size;
+
+            rhs.m_data = nullptr;
+            rhs.m_size = 0;
+            rhs.m_records = nullptr;
+            rhs.m_count = 0;
+            rhs.m_strings = nullptr;
+            rhs.m_strings_size = 0;
+        }
+
+        return *this;
+    }
+
+    size_t ResultLog::size() const
+    {
+        return m_count;
+    }
+
+    const ResultRecord* ResultLog::begin() const
+    {
+        return m_records;
+    }
+
+    const ResultRecord* ResultLog::end() const
+    {
+        return m_records + m_count;
+    }
+
+    const ResultRecord& ResultLog::operator[](size_t index) const
+    {
+        return m_records[index];
+    }
+
+    const char* ResultLog::name(const ResultRecord& record) const
+    {
+        return record.name < m_strings_size ? m_strings + record.name : "";
+    }
+
+    const char* ResultLog::message(const ResultRecord& record) const
+    {
+        return record.message < m_strings_size ? m_strings + record.message : "";
+    }
+
+    std::vector < const ResultRecord* > failures(const ResultLog& log)
+    {
+        std::vector < const ResultRecord* > result;
+
+        for (const ResultRecord& record : log)
+        {
+            if (record.failed())
+                result.push_back(&record);
+        }
+
+        return result;
+    }
+
+    std::vector < const ResultRecord* > slowest(const ResultLog& log, size_t count)
+    {
+        auto faster = [](const ResultRecord* lhs, const ResultRecord* rhs) {
+            return lhs->duration > rhs->duration;
+        };
+
+        std::priority_queue < const ResultRecord*, std::vector < const ResultRecord* >, decltype(faster) > heap(faster);
+
+        if (count == 0)
+            return {};
+
+        for (const ResultRecord& record : log)
+        {
+            if (heap.size() < count)
+                heap.push(&record);
+
+            else if (record.duration > heap.top()->duration)
+            {
+                heap.pop();
+                heap.push(&record);
+            }
+        }
+
+        std::vector < const ResultRecord* > result(heap.size());
+
+        for (size_t i = result.size(); i > 0; --i)
+        {
+            result[i - 1] = heap.top();
+            heap.pop();
+        }
+
+        return result;
+    }
+
+    void merge(const ResultLog& log, ResultLogWriter& writer)
+    {
+        for (const ResultRecord& record : log)
+            writer.append(record, log.name(record), log.message(record));
+    }
+
+    namespace
+    {
+        /** @brief Returns the last record of each unit of the log, sorted by identifier. */
+        std::vector < const ResultRecord* > last_records(const ResultLog& log)
+        {
+            // Sorts (identifier, index) pairs rather than pointers so the sort never touches the mapping.
+            std::vector < std::pair < uint64_t, size_t > > keys;
+            keys.reserve(log.size());
+
+            for (size_t i = 0; i < log.size(); ++i)
+                keys.emplace_back(log[i].id, i);
+
+            std::sort(keys.begin(), keys.end());
+
+            std::vector < const ResultRecord* > records;
+            records.reserve(keys.size());
+
+            for (size_t i = 0; i < keys.size(); ++i)
+            {
+                if (i + 1 < keys.size() && keys[i + 1].first == keys[i].first)
+                    continue;
+
+                records.push_back(&log[keys[i].second]);
+            }
+
+            return records;
+        }
+    }
+
+    std::vector < ResultDiff > diff(const ResultLog& before, const ResultLog& after)
+    {
+        auto lhs = last_records(before);
+        auto rhs = last_records(after);
+
+        std::vector < ResultDiff > result;
+        result.reserve(std::max(lhs.size(), rhs.size()));
+
+        size_t i = 0, j = 0;
+
+        while (i < lhs.size() || j < rhs.size())
+        {
+            if (j == rhs.size() || (i < lhs.size() && lhs[i]->id < rhs[j]->id))
+            {
+                result.push_back(ResultDiff { lhs[i]->id, lhs[i], nullptr });
+                ++i;
+            }
+
+            else if (i == lhs.size() || rhs[j]->id < lhs[i]->id)
+            {
+                result.push_back(ResultDiff { rhs[j]->id, nullptr, rhs[j] });
+                ++j;
+            }
+
+            else
+            {
+                result.push_back(ResultDiff { lhs[i]->id, lhs[i], rhs[j] });
+                ++i;
+                ++j;
+            }
+        }
+
+        return result;
+    }
+}
@@ -0,0 +1,118 @@
+//
+//  ATShard.cpp
+//  ATest
+//
+//  Created by jacques tronconi on 19/10/2026.
+//
+
+#include "ATShard.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <queue>
+
+namespace ATest
+{
+    namespace
+    {
+        /** @brief Reads a number from the environment. Returns false if the variable is not set. */
+        bool read_environment(const char* variable, size_t& value)
+        {
+            const char* text = std::getenv(variable);
+
+            if (!text || !*text)
+                return false;
+
+            char* end = nullptr;
+            unsigned long long number = std::strtoull(text, &end, 10);
+
+            if (*end != '\0' || *text == '-')
+                throw Error(EInvalidShard, std::string(variable) + " is not a valid number: '" + text + "'.");
+
+            value = static_cast < size_t >(number);
+            return true;
+        }
+    }
+
+    Shard Shard::from_environment()
+    {
+        Shard shard;
+
+        if (!read_environment("ATEST_SHARD_COUNT", shard.count))
+            return Shard();
+
+        read_environment("ATEST_SHARD_INDEX", shard.index);
+
+        if (shard.count == 0 || shard.index >= shard.count)
+        {
+            throw Error(EInvalidShard, "ATEST_SHARD_INDEX (" + std::to_string(shard.index) + ") must be lower than "
+                        "ATEST_SHARD_COUNT (" + std::to_string(shard.count) + ").");
+        }
+
+        return shard;
+    }
+
+    std::vector < size_t > partition(const std::vector < uint64_t >& ids, size_t count, const History* history)
+    {
+        std::vector < size_t > shards(ids.size(), 0);
+
+        if (count <= 1)
+            return shards;
+
+        std::vector < int64_t > costs(ids.size(), -1);
+        int64_t known_total = 0;
+        size_t known = 0;
+
+        for (size_t i = 0; i < ids.size(); ++i)
+        {
+            const HistoryEntry* entry = history ? history->find(ids[i]) : nullptr;
+
+            if (entry && entry->runs > 0)
+            {
+                costs[i] = std::max < int64_t >(entry->duration, 0);
+                known_total += costs[i];
+                known++;
+            }
+        }
+
+        int64_t unknown_cost = known ? std::max < int64_t >(known_total / static_cast < int64_t >(known), 1) : 1;
+
+        std::vector < size_t > order(ids.size());
+
+        for (size_t i = 0; i < order.size(); ++i)
+        {
+            order[i] = i;
+
+            if (costs[i] < 0)
+                costs[i] = unknown_cost;
+        }
+
+        std::sort(order.begin(), order.end(), [&ids, &costs](size_t lhs, size_t rhs) {
+            if (costs[lhs] != costs[rhs])
+                return costs[lhs] > costs[rhs];
+
+            if (ids[lhs] != ids[rhs])
+                return ids[lhs] < ids[rhs];
+
+            return lhs < rhs;
+        });
+
+        // The least loaded shard is on top; between equally loaded shards, the lowest index.
+        using Load = std::pair < int64_t, size_t >;
+        std::priority_queue < Load, std::vector < Load >, std::greater < Load > > loads;
+
+        for (size_t shard = 0; shard < count; ++shard)
+            loads.emplace(0, shard);
+
+        for (size_t i : order)
+        {
+            Load load = loads.top();
+            loads.pop();
+
+            shards[i] = load.second;
+            loads.emplace(load.first + costs[i], load.second);
+        }
+
+        return shards;
+    }
+}
@@ -10,9 +10,14 @@
 
 namespace ATest
 {
-    Test::Test(const std::string& name): m_name(name), m_group(std::make_shared<UnitGroup>())
+    Test::Test(const std::string& name): m_group(std::make_shared<UnitGroup>())
     {
+        setName(name);
         
+        Context context;
+        context.scope = name;
+        m_group->attach(context);
+        m_group->setShard(Shard::from_environment());
     }
     
     void Test::addUnit(const std::shared_ptr<UnitBase> &unit)
@@ -20,6 +25,11 @@ namespace ATest
         m_group->addUnit(unit);
     }
     
+    void Test::addFixture(const std::shared_ptr<FixtureBase> &fixture)
+    {
+        m_group->addFixture(fixture);
+    }
+    
     bool Test::run()
     {
         return m_group->run();
@@ -35,4 +45,55 @@ namespace ATest
     {
         return m_group->error();
     }
-}
+    
+    bool Test::holdsSubunits() const
+    {
+        return true;
+    }
+    
+    void Test::attach(const Context& context)
+    {
+        Context scoped = context;
+        scoped.scope = join_path(context.scope, name());
+        m_group->attach(scoped);
+        
+        // The parent is already sharded: partitioning the units of this test again would leave some of them out
+        // of every shard.
+        m_group->setShard(Shard());
+    }
+    
+    void Test::setReporter(const std::shared_ptr<Reporter> &reporter)
+    {
+        m_group->setReporter(reporter);
+    }
+    
+    void Test::setHistory(const std::shared_ptr<const History> &history)
+    {
+        m_group->setHistory(history);
+    }
+    
+    void Test::setProfiler(const std::shared_ptr<Profiler> &profiler)
+    {
+        m_group->setProfiler(profiler);
+    }
+    
+    void Test::setShard(const Shard &shard)
+    {
+        m_group->setShard(shard);
+    }
+    
+    void Test::setWorkers(size_t workers)
+    {
+        m_group->setWorkers(workers);
+    }
+    
+    void Test::setBreakOnError(bool should_break)
+    {
+        m_group->setBreakOnError(should_break);
+    }
+    
+    void Test::setCancellation(const std::shared_ptr<Cancellation> &cancellation)
+    {
+        m_group->setCancellation(cancellation);
+    }
+}
\ No newline at end of file
@@ -8,64 +8,447 @@
 
 #include "ATUnitGroup.h"
 
+#include <algorithm>
+
 namespace ATest
 {
-    UnitGroup::UnitGroup(): m_should_break_on_error(true)
+    UnitGroup::UnitGroup(): m_should_break_on_error(true), m_interrupted(false), m_owns_cancellation(true)
     {
-        
+        m_context.cancellation = std::make_shared < Cancellation >();
     }
     
     void UnitGroup::addUnit(const std::shared_ptr<UnitBase> &subunit)
     {
+        if (subunit && subunit->name().empty())
+            subunit->setName(std::to_string(m_subunits.size()));
+        
         m_subunits[subunit] = Error();
+        
+        if (subunit && (subunit->holdsSubunits() || m_context.reporter || m_context.history || m_context.profiler))
+            subunit->attach(subcontext(*subunit));
+    }
+    
+    void UnitGroup::addFixture(const std::shared_ptr<FixtureBase> &fixture)
+    {
+        if (!fixture)
+            return;
+        
+        m_fixtures.push_back(fixture);
+        fixture->attach(subcontext());
     }
     
     bool UnitGroup::run()
     {
-        m_error_happened = false;
+        m_error_happened.store(false, std::memory_order_relaxed);
         m_errored_subunit = nullptr;
         m_error = Error();
-        m_last_unit_runned = 0;
+        m_last_unit_runned.store(0, std::memory_order_relaxed);
+        m_interrupted.store(false, std::memory_order_relaxed);
         
-        for (auto& subunit : m_subunits)
+        // The path is only used to identify the subunits: the name of a group may change after it was attached.
+        if (m_context.reporter || m_context.profiler || m_context.history || m_shard.count > 1)
+            m_path = join_path(m_context.scope, name());
+        
+        // A Cancellation received from the parent group is already used by the parent's run. The group must not
+        // be attached while it runs, thus its Context keeps the Cancellation alive.
+        Cancellation* cancellation = m_owns_cancellation ? m_context.cancellation.get() : nullptr;
+        
+        if (cancellation)
+            cancellation->begin();
+        
+        for (auto& subunit_cancellation : m_subunit_cancellations)
+            subunit_cancellation->reset();
+        
+        for (auto& fixture : m_fixtures)
+            fixture->retain();
+        
+        try
         {
-            if (!subunit.first)
+            // Without history, shard nor workers, the subunits run in the order of the map: no schedule is needed.
+            if (m_context.history || m_shard.count > 1 || m_workers > 1)
+                run_scheduled();
+            
+            else
             {
-                m_error_happened = true;
-                m_error = Error(ENullSubUnit, "UnitGroup holds a null subunit.");
+                // The common case of nested groups: kept free of calls other than the subunits' run().
+                const Cancellation& current = *m_context.cancellation;
+                bool measured = m_context.reporter || m_context.profiler;
                 
-                if (!m_should_break_on_error)
+                for (auto& subunit : m_subunits)
                 {
-                    subunit.second = m_error;
-                    continue;
+                    if (current.isCancelled())
+                    {
+                        m_interrupted.store(true, std::memory_order_relaxed);
+                        break;
+                    }
+                    
+                    if (!subunit.first)
+                        fail(subunit, Error(ENullSubUnit, "UnitGroup holds a null subunit."));
+                    else if (!(measured ? run_subunit(subunit.first) : subunit.first->run()))
+                        fail(subunit, Error(EReturnedError, "A subunit has returned an error."));
+                    else
+                        m_last_unit_runned.store(m_last_unit_runned.load(std::memory_order_relaxed) + 1,
+                                                 std::memory_order_relaxed);
                 }
-                
-                break;
             }
+        }
+        
+        catch(...)
+        {
+            for (auto& fixture : m_fixtures)
+                fixture->release();
+            
+            if (cancellation)
+                cancellation->end();
+            
+            throw;
+        }
+        
+        for (auto& fixture : m_fixtures)
+            fixture->release();
+        
+        if (cancellation)
+            cancellation->end();
+        
+        if (m_interrupted.load(std::memory_order_relaxed) && !m_error_happened)
+        {
+            m_error_happened = true;
+            m_error = Error(ECancelled, "Run cancelled after a failure.");
+        }
+        
+        return !m_error_happened;
+    }
+    
+    Error UnitGroup::error() const
+    {
+        return m_error;
+    }
+    
+    bool UnitGroup::holdsSubunits() const
+    {
+        return true;
+    }
+    
+    void UnitGroup::attach(const Context& context)
+    {
+        // Attaching the same Cancellation again (to change the Reporter for example) keeps its owner.
+        m_owns_cancellation = !context.cancellation
+            || (context.cancellation == m_context.cancellation && m_owns_cancellation);
+        
+        m_context = context;
+        m_path = join_path(context.scope, name());
+        m_subunit_cancellations.clear();
+        
+        if (!m_context.cancellation)
+            m_context.cancellation = std::make_shared < Cancellation >();
+        
+        for (auto& subunit : m_subunits)
+        {
+            if (subunit.first)
+                subunit.first->attach(subcontext(*subunit.first));
+        }
+        
+        for (auto& fixture : m_fixtures)
+            fixture->attach(subcontext());
+    }
+    
+    void UnitGroup::setReporter(const std::shared_ptr<Reporter> &reporter)
+    {
+        Context context = m_context;
+        context.reporter = reporter;
+        attach(context);
+    }
+    
+    void UnitGroup::setHistory(const std::shared_ptr<const History> &history)
+    {
+        Context context = m_context;
+        context.history = history;
+        attach(context);
+    }
+    
+    void UnitGroup::setProfiler(const std::shared_ptr<Profiler> &profiler)
+    {
+        Context context = m_context;
+        context.profiler = profiler;
+        attach(context);
+    }
+    
+    void UnitGroup::setShard(const Shard &shard)
+    {
+        m_shard = shard;
+    }
+    
+    void UnitGroup::setWorkers(size_t workers)
+    {
+        m_workers = std::max < size_t >(workers, 1);
+    }
+    
+    void UnitGroup::setBreakOnError(bool should_break)
+    {
+        m_should_break_on_error = should_break;
+        attach(m_context);
+    }
+    
+    void UnitGroup::setCancellation(const std::shared_ptr<Cancellation> &cancellation)
+    {
+        Context context = m_context;
+        context.cancellation = cancellation;
+        attach(context);
+        
+        m_owns_cancellation = true;
+    }
+    
+    Context UnitGroup::subcontext() const
+    {
+        Context context = m_context;
+        context.scope = m_path;
+        return context;
+    }
+    
+    Context UnitGroup::subcontext(const UnitBase& subunit)
+    {
+        Context context = subcontext();
+        
+        // A group breaking on error stops with its subunits. Otherwise each subgroup stops on its own failures,
+        // or with this group. Other subunits never look at their Cancellation: they share this group's one.
+        if (!m_should_break_on_error && subunit.holdsSubunits())
+        {
+            context.cancellation = std::make_shared < Cancellation >(m_context.cancellation);
+            m_subunit_cancellations.push_back(context.cancellation);
+        }
+        
+        return context;
+    }
+    
+    std::vector < UnitGroup::Entry* > UnitGroup::schedule()
+    {
+        std::vector < Entry* > entries;
+        entries.reserve(m_subunits.size());
+        
+        for (auto& subunit : m_subunits)
+            entries.push_back(&subunit);
+        
+        const History* history = m_context.history.get();
+        
+        if (m_shard.count <= 1 && !history)
+            return entries;
+        
+        std::vector < uint64_t > ids;
+        ids.reserve(entries.size());
+        
+        for (const Entry* entry : entries)
+            ids.push_back(entry->first ? unit_id(join_path(m_path, entry->first->name())) : 0);
+        
+        std::vector < size_t > indices;
+        indices.reserve(entries.size());
+        
+        if (m_shard.count > 1)
+        {
+            std::vector < size_t > shards = partition(ids, m_shard.count, history);
+            
+            for (size_t i = 0; i < shards.size(); ++i)
+            {
+                if (shards[i] == m_shard.index)
+                    indices.push_back(i);
+            }
+        }
+        
+        else
+        {
+            for (size_t i = 0; i < entries.size(); ++i)
+                indices.push_back(i);
+        }
+        
+        if (history)
+        {
+            // A unit failed 'recently' if it failed in one of the last kRecentRuns runs recorded by the history.
+            constexpr uint64_t kRecentRuns = 10;
             
-            else if (!subunit.first->run())
+            struct Key
             {
-                m_error_happened = true;
-                m_error = Error(EReturnedError, "A subunit has returned an error.");
-                m_errored_subunit = subunit.first;
+                int tier;
+                uint64_t last_failure;
+                int64_t duration;
+            };
+            
+            std::vector < Key > keys(entries.size());
+            
+            for (size_t i : indices)
+            {
+                const HistoryEntry* known = entries[i]->first ? history->find(ids[i]) : nullptr;
+                Key& key = keys[i];
                 
-                if (!m_should_break_on_error)
-                {
-                    subunit.second = m_error;
-                    continue;
-                }
+                if (!entries[i]->first)
+                    key = Key{ 0, ~uint64_t(0), 0 };
+                else if (!known)
+                    key = Key{ 2, 0, 0 };
+                else if (known->last_failure && history->generation() - known->last_failure < kRecentRuns)
+                    key = Key{ 1, known->last_failure, known->duration };
+                else
+                    key = Key{ 3, 0, known->duration };
+            }
+            
+            // Null subunits first (they fail at once), then recently failed units from the most recent failure,
+            // then units the history doesn't know (new or renamed, thus likely changed), then the others. Inside a
+            // tier, the longest units start first so that workers end at the same time.
+            std::sort(indices.begin(), indices.end(), [&](size_t lhs, size_t rhs){
+                const Key& a = keys[lhs];
+                const Key& b = keys[rhs];
+                
+                if (a.tier != b.tier)
+                    return a.tier < b.tier;
+                if (a.last_failure != b.last_failure)
+                    return a.last_failure > b.last_failure;
+                if (a.duration != b.duration)
+                    return a.duration > b.duration;
+                if (ids[lhs] != ids[rhs])
+                    return ids[lhs] < ids[rhs];
                 
-                break;
+                return lhs < rhs;
+            });
+        }
+        
+        std::vector < Entry* > order;
+        order.reserve(indices.size());
+        
+        for (size_t i : indices)
+            order.push_back(entries[i]);
+        
+        return order;
+    }
+    
+    void UnitGroup::run_scheduled()
+    {
+        std::vector < Entry* > order = schedule();
+        std::atomic < size_t > next(0);
+        size_t workers = std::min(m_workers, std::max < size_t >(order.size(), 1));
+        
+        if (workers == 1)
+        {
+            run_worker(order, next);
+            return;
+        }
+        
+        std::vector < std::future < void > > futures;
+        futures.reserve(workers - 1);
+        
+        for (size_t i = 1; i < workers; ++i)
+            futures.push_back(std::async(std::launch::async, [this, &order, &next](){ run_worker(order, next); }));
+        
+        std::exception_ptr exception;
+        
+        try
+        {
+            run_worker(order, next);
+        }
+        
+        catch(...)
+        {
+            exception = std::current_exception();
+        }
+        
+        for (auto& future : futures)
+        {
+            try
+            {
+                future.get();
             }
             
+            catch(...)
+            {
+                if (!exception)
+                    exception = std::current_exception();
+            }
+        }
+        
+        if (exception)
+            std::rethrow_exception(exception);
+    }
+    
+    bool UnitGroup::isCancelled() const
+    {
+        return m_context.cancellation->isCancelled();
+    }
+    
+    void UnitGroup::run_worker(const std::vector<Entry *> &schedule, std::atomic<size_t> &next)
+    {
+        while (!isCancelled())
+        {
+            size_t index = next.fetch_add(1, std::memory_order_relaxed);
+            
+            if (index >= schedule.size())
+                return;
+            
+            run_entry(*schedule[index]);
+        }
+        
+        if (next.load(std::memory_order_relaxed) < schedule.size())
+            m_interrupted.store(true, std::memory_order_relaxed);
+    }
+    
+    void UnitGroup::run_entry(Entry &entry)
+    {
+        if (!entry.first)
+            fail(entry, Error(ENullSubUnit, "UnitGroup holds a null subunit."));
+        
+        else if (!run_subunit(entry.first))
+            fail(entry, Error(EReturnedError, "A subunit has returned an error."));
+        
+        else
             m_last_unit_runned++;
+    }
+    
+    void UnitGroup::fail(Entry &entry, const Error &error)
+    {
+        std::lock_guard < std::mutex > lock(m_error_mutex);
+        
+        m_error_happened = true;
+        m_error = error;
+        
+        if (entry.first)
+            m_errored_subunit = entry.first;
+        
+        if (!m_should_break_on_error)
+        {
+            entry.second = error;
+            return;
         }
         
-        return !m_error_happened;
+        m_context.cancellation->cancel();
     }
     
-    Error UnitGroup::error() const
+    bool UnitGroup::run_subunit(const std::shared_ptr<UnitBase> &subunit)
     {
-        return m_error;
+        if (!m_context.reporter && !m_context.profiler)
+            return subunit->run();
+        
+        bool is_group = subunit->holdsSubunits();
+        bool sampled = m_context.profiler && !is_group && m_context.profiler->begin();
+        
+        auto setup = FixtureBase::threadSetupTime();
+        auto start = std::chrono::steady_clock::now();
+        bool result = subunit->run();
+        auto end = std::chrono::steady_clock::now();
+        setup = FixtureBase::threadSetupTime() - setup;
+        
+        std::string path = join_path(m_path, subunit->name());
+        
+        if (sampled)
+            m_context.profiler->end(path);
+        
+        if (!m_context.reporter)
+            return result;
+        
+        Report report;
+        report.path = std::move(path);
+        report.id = unit_id(report.path);
+        report.kind = is_group ? EGroupReport : EUnitReport;
+        report.duration = std::chrono::duration_cast < std::chrono::nanoseconds >(end - start) - setup;
+        
+        if (!result)
+            report.error = subunit->error();
+        
+        m_context.reporter->report(report);
+        return result;
     }
 }
@@ -75,6 +75,11 @@ namespace ATest
         return group->error();
     }
     
+    bool UnitThread::holdsSubunits() const
+    {
+        return true;
+    }
+    
     bool UnitThread::isRunning() const
     {
         return m_is_running;
@@ -91,6 +96,17 @@ namespace ATest
         }
     }
     
+    void UnitThread::attach(const Context& context)
+    {
+        auto group = std::atomic_load(&m_unit_group);
+        
+        if (group)
+        {
+            std::lock_guard < std::mutex > lock(m_mutex);
+            group->attach(context);
+        }
+    }
+    
     bool UnitThread::wait()
     {
         m_running_thread.wait();
@@ -0,0 +1,175 @@
+//
+//  ATFixtureTests.cpp
+//  ATest
+//
+//  Checks that a fixture is set up once, torn down by its last user, and that its set up is reported apart from
+//  the units using it.
+//
+
+#include "ATTestSupport.h"
+
+using namespace ATest;
+using namespace ATest::Tests;
+
+namespace
+{
+    //! @brief The number of set ups and tear downs of the fixtures.
+    std::atomic < int > g_setups(0);
+    std::atomic < int > g_teardowns(0);
+
+    /** @brief The value held by the fixtures: counts its tear down. */
+    struct Resource
+    {
+        int value = 42;
+
+        ~Resource()
+        {
+            g_teardowns++;
+        }
+    };
+
+    using ResourceFixture = Fixture < std::shared_ptr < Resource > >;
+
+    /** @brief Returns a fixture whose set up lasts 'milliseconds'. */
+    std::shared_ptr < ResourceFixture > make_resource(int milliseconds)
+    {
+        g_setups = 0;
+        g_teardowns = 0;
+
+        return make_fixture < std::shared_ptr < Resource > >("resource", [milliseconds](){
+            std::this_thread::sleep_for(std::chrono::milliseconds(milliseconds));
+            g_setups++;
+            return std::make_shared < Resource >();
+        });
+    }
+
+    bool use(std::shared_ptr < ResourceFixture > fixture, int milliseconds)
+    {
+        bool valid = fixture->get()->value == 42;
+        std::this_thread::sleep_for(std::chrono::milliseconds(milliseconds));
+        return valid;
+    }
+
+    void setup_once()
+    {
+        auto fixture = make_resource(50);
+        Test test("once");
+        test.addFixture(fixture);
+
+        for (int i = 0; i < 8; ++i)
+            test.addUnit(make_unit(true, use, fixture, 0));
+
+        test.setWorkers(8);
+
+        check(test.run(), std::string("a unit failed: ") + test.error().what());
+        check(g_setups == 1, std::to_string(g_setups) + " set ups for 8 workers");
+        check(g_teardowns == 1 && !fixture->isReady(), "the fixture wasn't torn down after the run");
+    }
+
+    void teardown_on_last_release()
+    {
+        auto fixture = make_resource(0);
+        fixture->retain();
+        fixture->retain();
+        fixture->get();
+
+        fixture->release();
+        check(fixture->isReady() && g_teardowns == 0, "the fixture was torn down with a user left");
+
+        fixture->release();
+        check(!fixture->isReady() && g_teardowns == 1, "the fixture wasn't torn down by its last user");
+    }
+
+    void shared_by_two_groups()
+    {
+        auto fixture = make_resource(0);
+        Test test("shared");
+
+        for (const char* name : { "a", "b" })
+        {
+            auto group = std::make_shared < UnitGroup >();
+            group->setName(name);
+            group->addFixture(fixture);
+            group->addUnit(make_unit(true, use, fixture, 50));
+            test.addUnit(group);
+        }
+
+        // Both groups run simultaneously: the first one to finish doesn't tear down the fixture of the other.
+        test.setWorkers(2);
+
+        check(test.run(), std::string("a unit failed: ") + test.error().what());
+        check(g_setups == 1, std::to_string(g_setups) + " set ups for two groups runned together");
+        check(g_teardowns == 1 && !fixture->isReady(), "the fixture wasn't torn down after both groups");
+    }
+
+    void failed_setup()
+    {
+        g_setups = 0;
+
+        auto fixture = make_fixture < int >("broken", [](){
+            g_setups++;
+            throw std::runtime_error("no dataset");
+            return 0;
+        });
+
+        auto reporter = std::make_shared < RecordingReporter >();
+        Test test("broken");
+        test.addFixture(fixture);
+        test.setBreakOnError(false);
+        test.setReporter(reporter);
+
+        for (int i = 0; i < 3; ++i)
+            test.addUnit(make_unit(true, +[](std::shared_ptr < Fixture < int > > f){ return f->get() == 0; }, fixture));
+
+        check(!test.run(), "the units using a broken fixture succeeded");
+        check(g_setups == 1, std::to_string(g_setups) + " set ups of a broken fixture");
+
+        std::vector < Report > units = reporter->reports(EUnitReport);
+        check(units.size() == 3, "expected 3 unit reports");
+
+        for (const Report& report : units)
+        {
+            check(report.error.code() == EReturnedError && std::string(report.error.what()) == "no dataset",
+                  report.path + " didn't receive the set up error: " + report.error.what());
+        }
+
+        std::vector < Report > fixtures = reporter->reports(EFixtureReport);
+        check(fixtures.size() == 1 && fixtures[0].error.code() == EReturnedError, "the failed set up wasn't reported");
+    }
+
+    void setup_time_reported()
+    {
+        auto fixture = make_resource(100);
+        auto reporter = std::make_shared < RecordingReporter >();
+        Test test("timed");
+        test.addFixture(fixture);
+        test.addUnit(make_unit(true, use, fixture, 0));
+        test.addUnit(make_unit(true, use, fixture, 0));
+        test.setWorkers(2);
+        test.setReporter(reporter);
+
+        check(test.run(), std::string("a unit failed: ") + test.error().what());
+
+        std::vector < Report > fixtures = reporter->reports(EFixtureReport);
+        check(fixtures.size() == 1 && fixtures[0].path == "timed/resource", "the set up wasn't reported once");
+        check(fixtures[0].duration >= std::chrono::milliseconds(100), "the set up time is too short");
+
+        for (const Report& report : reporter->reports(EUnitReport))
+        {
+            check(report.duration < std::chrono::milliseconds(50), report.path + " counts the set up: "
+                  + std::to_string(report.duration.count()) + " ns");
+        }
+    }
+}
+
+int main(int argc, char** argv)
+{
+    Test test("fixture");
+    add_test(test, "setup_once", setup_once);
+    add_test(test, "teardown_on_last_release", teardown_on_last_release);
+    add_test(test, "shared_by_two_groups", shared_by_two_groups);
+    add_test(test, "failed_setup", failed_setup);
+    add_test(test, "setup_time_reported", setup_time_reported);
+
+    return run_tests(test, argc, argv);
+}
@@ -0,0 +1,162 @@
+//
+//  ATHistoryTests.cpp
+//  ATest
+//
+//  Records result logs into a History, and saves and loads it.
+//
+
+#include "ATTestSupport.h"
+#include "ATResultLog.h"
+
+#include <cstdio>
+#include <fstream>
+
+using namespace ATest;
+using namespace ATest::Tests;
+
+namespace
+{
+    /** @brief Writes a log with one record per unit: 'a' lasts 'duration' and fails if 'fail_a', 'b' lasts 10. */
+    void write_run(const std::string& path, int64_t duration, bool fail_a)
+    {
+        ResultLogWriter writer(path);
+
+        Report a;
+        a.path = "suite/a";
+        a.id = unit_id(a.path);
+        a.duration = std::chrono::nanoseconds(duration);
+
+        if (fail_a)
+            a.error = Error(EResultInvalid, "failed");
+
+        Report b;
+        b.path = "suite/b";
+        b.id = unit_id(b.path);
+        b.duration = std::chrono::nanoseconds(10);
+
+        writer.report(a);
+        writer.report(b);
+        writer.close();
+    }
+
+    void missing_file()
+    {
+        std::string path = test_file("missing.history");
+        std::remove(path.c_str());
+
+        History history = History::load(path);
+        check(history.size() == 0 && history.generation() == 0, "a missing history isn't empty");
+    }
+
+    void record_runs()
+    {
+        std::string path = test_file("run.atrl");
+        History history;
+
+        write_run(path, 100, true);
+        history.record(ResultLog(path));
+        write_run(path, 300, false);
+        history.record(ResultLog(path));
+
+        const HistoryEntry* a = history.find(unit_id("suite/a"));
+        const HistoryEntry* b = history.find(unit_id("suite/b"));
+
+        check(history.generation() == 2, "expected 2 recorded runs");
+        check(a && b && history.size() == 2, "expected 2 recorded units");
+        check(a->duration == 200, "the duration of 'a' is " + std::to_string(a->duration));
+        check(a->runs == 2 && a->failures == 1 && a->last_failure == 1, "wrong runs or failures for 'a'");
+        check(b->runs == 2 && b->failures == 0 && b->last_failure == 0, "wrong runs or failures for 'b'");
+        check(!history.find(unit_id("suite/c")), "an unknown unit was found");
+    }
+
+    void cancelled_group()
+    {
+        std::string path = test_file("run.atrl");
+        History history;
+
+        write_run(path, 100, false);
+        history.record(ResultLog(path));
+
+        {
+            ResultLogWriter writer(path);
+
+            Report a;
+            a.kind = EGroupReport;
+            a.path = "suite/a";
+            a.id = unit_id(a.path);
+            a.duration = std::chrono::nanoseconds(5);
+            a.error = Error(ECancelled, "Run cancelled after a failure.");
+
+            writer.report(a);
+            writer.close();
+        }
+
+        ResultLog log(path);
+        history.record(log);
+
+        const HistoryEntry* a = history.find(unit_id("suite/a"));
+        check(failures(log).empty(), "a cancelled group is listed as a failure");
+        check(history.generation() == 2, "the run with a cancelled group wasn't recorded");
+        check(a && a->runs == 1 && a->duration == 100, "the cut short run of 'a' was recorded");
+        check(a->failures == 0 && a->last_failure == 0, "the cancelled group was recorded as a failure");
+    }
+
+    void save_then_load()
+    {
+        std::string log_path = test_file("run.atrl");
+        std::string path = test_file("round_trip.history");
+        History history;
+
+        write_run(log_path, 100, true);
+        history.record(ResultLog(log_path));
+        write_run(log_path, 50, false);
+        history.record(ResultLog(log_path));
+        history.save(path);
+
+        History loaded = History::load(path);
+        check(loaded.generation() == history.generation(), "the generation wasn't saved");
+        check(loaded.size() == history.size(), "the entries weren't saved");
+
+        for (const char* name : { "suite/a", "suite/b" })
+        {
+            const HistoryEntry* saved = history.find(unit_id(name));
+            const HistoryEntry* read = loaded.find(unit_id(name));
+
+            check(read != nullptr, std::string(name) + " wasn't loaded");
+            check(read->duration == saved->duration && read->runs == saved->runs
+                  && read->failures == saved->failures && read->last_failure == saved->last_failure,
+                  std::string(name) + " was loaded with different values");
+        }
+    }
+
+    void invalid_file()
+    {
+        std::string path = test_file("invalid.history");
+        std::ofstream(path) << "not a history\n";
+
+        try
+        {
+            History::load(path);
+        }
+
+        catch(const Error& error)
+        {
+            check(error.code() == EInvalidFormat, "an invalid history throws the wrong error");
+            return;
+        }
+
+        check(false, "an invalid history was loaded");
+    }
+}
+
+int main(int argc, char** argv)
+{
+    Test test("history");
+    add_test(test, "missing_file", missing_file);
+    add_test(test, "record_runs", record_runs);
+    add_test(test, "cancelled_group", cancelled_group);
+    add_test(test, "save_then_load", save_then_load);
+    add_test(test, "invalid_file", invalid_file);
+
+    return run_tests(test, argc, argv);
+}
@@ -0,0 +1,87 @@
+//
+//  ATProfilerTests.cpp
+//  ATest
+//
+//  Checks that the samples of a unit are given to the unit itself, and never to the groups holding it.
+//
+
+#include "ATTestSupport.h"
+#include "ATProfiler.h"
+
+#include <ctime>
+
+using namespace ATest;
+using namespace ATest::Tests;
+
+/** @brief Spends about 200 ms of CPU time in pure arithmetic. Not static, so that -rdynamic exports its name. */
+__attribute__((noinline)) bool atest_burn_cpu()
+{
+    volatile unsigned long long sum = 0;
+    std::timespec start, now;
+    ::clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+
+    do
+    {
+        for (unsigned i = 0; i < 1000000; ++i)
+            sum = sum + i;
+
+        ::clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now);
+    }
+    while ((now.tv_sec - start.tv_sec) * 1000000000L + (now.tv_nsec - start.tv_nsec) < 200000000L);
+
+    return true;
+}
+
+namespace
+{
+    /** @brief Returns the number of samples of a profile, and of those whose stack contains 'function'. */
+    std::pair < size_t, size_t > count_samples(const std::map < std::string, size_t >& profile,
+                                               const std::string& function)
+    {
+        std::pair < size_t, size_t > counts(0, 0);
+
+        for (const auto& stack : profile)
+        {
+            counts.first += stack.second;
+
+            if (stack.first.find(function) != std::string::npos)
+                counts.second += stack.second;
+        }
+
+        return counts;
+    }
+
+    void samples_under_unit()
+    {
+        auto profiler = std::make_shared < Profiler >(g_directory, 997);
+
+        auto unit = make_unit(true, atest_burn_cpu);
+        unit->setName("burn");
+
+        auto group = std::make_shared < UnitGroup >();
+        group->setName("group");
+        group->addUnit(unit);
+
+        Test test("profiled");
+        test.addUnit(group);
+        test.setProfiler(profiler);
+        check(test.run(), "the profiled test failed");
+
+        std::pair < size_t, size_t > unit_samples = count_samples(profiler->profile("profiled/group/burn"),
+                                                                  "atest_burn_cpu");
+        check(unit_samples.first > 0, "the unit has no samples");
+        check(unit_samples.second * 2 > unit_samples.first, "only " + std::to_string(unit_samples.second) + " of "
+              + std::to_string(unit_samples.first) + " samples are in atest_burn_cpu");
+
+        check(profiler->profile("profiled/group").empty(), "the group has samples");
+        check(profiler->profile("profiled").empty(), "the test has samples");
+    }
+}
+
+int main(int argc, char** argv)
+{
+    Test test("profiler");
+    add_test(test, "samples_under_unit", samples_under_unit);
+
+    return run_tests(test, argc, argv);
+}
@@ -0,0 +1,145 @@
+//
+//  ATResultLogTests.cpp
+//  ATest
+//
+//  Writes result logs with ResultLogWriter and reads them back with ResultLog and merge().
+//
+
+#include "ATTestSupport.h"
+#include "ATResultLog.h"
+
+#include <fstream>
+
+using namespace ATest;
+using namespace ATest::Tests;
+
+namespace
+{
+    /** @brief Writes a log of 'count' records named '<prefix>/<index>', the odd ones failing. */
+    void write_log(const std::string& path, const std::string& prefix, size_t count)
+    {
+        ResultLogWriter writer(path);
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            Report report;
+            report.path = prefix + "/" + std::to_string(i);
+            report.id = unit_id(report.path);
+            report.kind = i == 0 ? EGroupReport : EUnitReport;
+            report.duration = std::chrono::nanoseconds(1000 * (i + 1));
+
+            if (i % 2)
+                report.error = Error(EResultInvalid, "failure " + std::to_string(i));
+
+            writer.report(report);
+        }
+
+        writer.close();
+    }
+
+    /** @brief Checks that the log holds the records written by write_log(), starting at 'first'. */
+    void check_log(const ResultLog& log, size_t first, const std::string& prefix, size_t count)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            const ResultRecord& record = log[first + i];
+            std::string path = prefix + "/" + std::to_string(i);
+
+            check(log.name(record) == path, "record " + std::to_string(i) + " is named " + log.name(record));
+            check(record.id == unit_id(path), "wrong id for " + path);
+            check(record.duration == static_cast < int64_t >(1000 * (i + 1)), "wrong duration for " + path);
+            check(record.kind == (i == 0 ? EGroupReport : EUnitReport), "wrong kind for " + path);
+
+            if (i % 2)
+            {
+                check(record.code == EResultInvalid, "wrong code for " + path);
+                check(log.message(record) == "failure " + std::to_string(i), "wrong message for " + path);
+            }
+
+            else
+            {
+                check(record.code == ENoError, "wrong code for " + path);
+                check(*log.message(record) == '\0', "a passed record has a message: " + path);
+            }
+        }
+    }
+
+    void write_then_read()
+    {
+        std::string path = test_file("round_trip.atrl");
+        write_log(path, "suite", 100);
+
+        ResultLog log(path);
+        check(log.size() == 100, "expected 100 records, got " + std::to_string(log.size()));
+        check_log(log, 0, "suite", 100);
+        check(failures(log).size() == 50, "expected 50 failures");
+        check(slowest(log, 1).front() == &log[99], "the slowest record isn't the last one");
+    }
+
+    void empty_log()
+    {
+        std::string path = test_file("empty.atrl");
+        ResultLogWriter(path).close();
+
+        ResultLog log(path);
+        check(log.size() == 0, "an empty log has records");
+        check(log.begin() == log.end(), "an empty log isn't empty");
+    }
+
+    void merge_logs()
+    {
+        std::string first = test_file("shard0.atrl");
+        std::string second = test_file("shard1.atrl");
+        std::string merged = test_file("merged.atrl");
+        write_log(first, "shard0", 10);
+        write_log(second, "shard1", 7);
+
+        ResultLogWriter writer(merged);
+        merge(ResultLog(first), writer);
+        merge(ResultLog(second), writer);
+        writer.close();
+
+        ResultLog log(merged);
+        check(log.size() == 17, "expected 17 merged records, got " + std::to_string(log.size()));
+        check_log(log, 0, "shard0", 10);
+        check_log(log, 10, "shard1", 7);
+    }
+
+    void truncated_log()
+    {
+        std::string path = test_file("truncated.atrl");
+        write_log(path, "suite", 10);
+
+        std::string bytes;
+        {
+            std::ifstream input(path, std::ios::binary);
+            bytes.assign(std::istreambuf_iterator < char >(input), std::istreambuf_iterator < char >());
+        }
+
+        std::ofstream(path, std::ios::binary | std::ios::trunc).write(bytes.data(), bytes.size() - 1);
+
+        try
+        {
+            ResultLog log(path);
+        }
+
+        catch(const Error& error)
+        {
+            check(error.code() == EInvalidFormat, "a truncated log throws the wrong error");
+            return;
+        }
+
+        check(false, "a truncated log was opened");
+    }
+}
+
+int main(int argc, char** argv)
+{
+    Test test("result_log");
+    add_test(test, "write_then_read", write_then_read);
+    add_test(test, "empty_log", empty_log);
+    add_test(test, "merge_logs", merge_logs);
+    add_test(test, "truncated_log", truncated_log);
+
+    return run_tests(test, argc, argv);
+}
@@ -0,0 +1,259 @@
+//
+//  ATShardTests.cpp
+//  ATest
+//
+//  Checks that partition() gives every unit to exactly one shard, the same way in every process.
+//
+
+#include "ATTestSupport.h"
+#include "ATResultLog.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <random>
+#include <set>
+
+using namespace ATest;
+using namespace ATest::Tests;
+
+namespace
+{
+    //! @brief The number of units partitioned by the tests.
+    constexpr size_t kUnits = 200;
+
+    /** @brief Returns the identifiers of the units 'suite/<index>'. */
+    std::vector < uint64_t > make_ids()
+    {
+        std::vector < uint64_t > ids;
+
+        for (size_t i = 0; i < kUnits; ++i)
+            ids.push_back(unit_id("suite/" + std::to_string(i)));
+
+        return ids;
+    }
+
+    /** @brief Returns a History where the unit 'suite/<index>' lasted (index % 17 + 1) microseconds, and where
+     *  the units after kUnits / 2 are unknown. */
+    History make_history()
+    {
+        std::string path = test_file("shard.atrl");
+
+        {
+            ResultLogWriter writer(path);
+
+            for (size_t i = 0; i < kUnits / 2; ++i)
+            {
+                Report report;
+                report.path = "suite/" + std::to_string(i);
+                report.id = unit_id(report.path);
+                report.duration = std::chrono::microseconds(i % 17 + 1);
+                writer.report(report);
+            }
+
+            writer.close();
+        }
+
+        History history;
+        history.record(ResultLog(path));
+        return history;
+    }
+
+    /** @brief Checks that every unit has a valid shard and that the partition doesn't depend on the order of
+     *  the units, which is the order of their addresses in a UnitGroup. */
+    void check_partition(const History* history)
+    {
+        std::vector < uint64_t > ids = make_ids();
+
+        for (size_t count : { 1, 2, 3, 8, 500 })
+        {
+            std::vector < size_t > shards = partition(ids, count, history);
+            check(shards.size() == ids.size(), "partition() didn't return a shard for each unit");
+
+            for (size_t shard : shards)
+                check(shard < count, "a unit has shard " + std::to_string(shard) + " of " + std::to_string(count));
+
+            check(partition(ids, count, history) == shards, "partition() isn't deterministic");
+
+            std::vector < size_t > order(ids.size());
+            for (size_t i = 0; i < order.size(); ++i)
+                order[i] = i;
+
+            std::shuffle(order.begin(), order.end(), std::mt19937(static_cast < unsigned >(count)));
+
+            std::vector < uint64_t > shuffled;
+            for (size_t i : order)
+                shuffled.push_back(ids[i]);
+
+            std::vector < size_t > shuffled_shards = partition(shuffled, count, history);
+
+            for (size_t i = 0; i < order.size(); ++i)
+                check(shuffled_shards[i] == shards[order[i]], "the partition depends on the order of the units");
+        }
+    }
+
+    void without_history()
+    {
+        check_partition(nullptr);
+
+        // Without history every unit costs the same: the shards differ by one unit at most.
+        std::vector < size_t > shards = partition(make_ids(), 3, nullptr);
+        std::vector < size_t > sizes(3, 0);
+
+        for (size_t shard : shards)
+            sizes[shard]++;
+
+        check(*std::max_element(sizes.begin(), sizes.end()) - *std::min_element(sizes.begin(), sizes.end()) <= 1,
+              "the shards are not balanced");
+    }
+
+    void with_history()
+    {
+        History history = make_history();
+        check_partition(&history);
+
+        // Unknown units are expected to last the mean duration of the known ones. Longest-first, the shards then
+        // differ by the longest unit at most.
+        std::vector < uint64_t > ids = make_ids();
+        std::vector < size_t > shards = partition(ids, 4, &history);
+        std::vector < int64_t > totals(4, 0);
+        int64_t known_total = 0;
+        int64_t longest = 0;
+
+        for (size_t i = 0; i < kUnits / 2; ++i)
+            known_total += history.find(ids[i])->duration;
+
+        for (size_t i = 0; i < ids.size(); ++i)
+        {
+            const HistoryEntry* entry = history.find(ids[i]);
+            int64_t cost = entry ? entry->duration : known_total / static_cast < int64_t >(kUnits / 2);
+            totals[shards[i]] += cost;
+            longest = std::max(longest, cost);
+        }
+
+        check(*std::max_element(totals.begin(), totals.end()) - *std::min_element(totals.begin(), totals.end())
+              <= longest, "the shards are not balanced by their history");
+    }
+
+    /** @brief Collects the paths of the units runned. */
+    class PathReporter : public Reporter
+    {
+        std::mutex m_mutex;
+
+    public:
+        std::multiset < std::string > paths;
+
+        void report(const Report& report)
+        {
+            std::lock_guard < std::mutex > lock(m_mutex);
+
+            if (report.kind == EUnitReport)
+                paths.insert(report.path);
+        }
+    };
+
+    bool pass()
+    {
+        return true;
+    }
+
+    /** @brief Builds a suite of 45 units, in nested tests and groups, the way a sharded process builds it: every
+     *  Test reads ATEST_SHARD_INDEX and ATEST_SHARD_COUNT. */
+    std::shared_ptr < Test > make_suite()
+    {
+        auto suite = std::make_shared < Test >("suite");
+
+        for (int i = 0; i < 4; ++i)
+        {
+            auto nested = std::make_shared < Test >("nested" + std::to_string(i));
+
+            for (int j = 0; j < 10; ++j)
+                nested->addUnit(make_unit(true, pass));
+
+            suite->addUnit(nested);
+        }
+
+        auto group = std::make_shared < UnitGroup >();
+        group->setName("group");
+
+        for (int j = 0; j < 3; ++j)
+            group->addUnit(make_unit(true, pass));
+
+        suite->addUnit(group);
+        suite->addUnit(make_unit(true, pass));
+        suite->addUnit(make_unit(true, pass));
+
+        return suite;
+    }
+
+    void sharded_suite()
+    {
+        constexpr size_t kShards = 3;
+
+        std::multiset < std::string > all;
+        std::multiset < std::string > sharded;
+
+        auto reporter = std::make_shared < PathReporter >();
+        std::shared_ptr < Test > whole = make_suite();
+        whole->setReporter(reporter);
+        whole->run();
+        all = reporter->paths;
+
+        check(all.size() == 45, "the whole suite ran " + std::to_string(all.size()) + " units");
+
+        for (size_t index = 0; index < kShards; ++index)
+        {
+            ::setenv("ATEST_SHARD_COUNT", std::to_string(kShards).c_str(), 1);
+            ::setenv("ATEST_SHARD_INDEX", std::to_string(index).c_str(), 1);
+
+            std::shared_ptr < Test > suite = make_suite();
+
+            ::unsetenv("ATEST_SHARD_COUNT");
+            ::unsetenv("ATEST_SHARD_INDEX");
+
+            auto shard_reporter = std::make_shared < PathReporter >();
+            suite->setReporter(shard_reporter);
+            suite->run();
+            sharded.insert(shard_reporter->paths.begin(), shard_reporter->paths.end());
+        }
+
+        check(sharded == all, "the shards ran " + std::to_string(sharded.size()) + " units instead of each of the "
+              + std::to_string(all.size()) + " units once");
+    }
+
+    void environment()
+    {
+        ::setenv("ATEST_SHARD_COUNT", "4", 1);
+        ::setenv("ATEST_SHARD_INDEX", "2", 1);
+        Shard shard = Shard::from_environment();
+        check(shard.count == 4 && shard.index == 2, "the shard wasn't read from the environment");
+
+        ::setenv("ATEST_SHARD_INDEX", "4", 1);
+        bool thrown = false;
+
+        try
+        {
+            Shard::from_environment();
+        }
+
+        catch(const Error& error)
+        {
+            thrown = error.code() == EInvalidShard;
+        }
+
+        ::unsetenv("ATEST_SHARD_COUNT");
+        ::unsetenv("ATEST_SHARD_INDEX");
+        check(thrown, "an index out of the shards was accepted");
+        check(Shard::from_environment().count == 1, "without environment, the shard doesn't run all units");
+    }
+}
+
+int main(int argc, char** argv)
+{
+    Test test("shard");
+    add_test(test, "without_history", without_history);
+    add_test(test, "with_history", with_history);
+    add_test(test, "sharded_suite", sharded_suite);
+    add_test(test, "environment", environment);
+
+    return run_tests(test, argc, argv);
+}
@@ -0,0 +1,109 @@
+//
+//  ATTestSupport.h
+//  ATest
+//
+//  Helpers shared by the tests of ATest, which are themselves written with ATest: each test is a void unit that
+//  throws when a check fails.
+//
+
+#ifndef ATTestSupport_h
+#define ATTestSupport_h
+
+#include "ATTest.h"
+
+#include <cstdio>
+#include <stdexcept>
+
+namespace ATest
+{
+    namespace Tests
+    {
+        //! @brief The directory where the tests write their files, given as the first argument.
+        inline std::string g_directory = ".";
+
+        /** @brief Prints every failed unit with its error. */
+        class PrintingReporter : public Reporter
+        {
+            std::mutex m_mutex;
+
+        public:
+            void report(const Report& report)
+            {
+                if (report.kind != EUnitReport)
+                    return;
+
+                std::lock_guard < std::mutex > lock(m_mutex);
+
+                if (report.error.code() == ENoError)
+                    std::printf("ok      %s\n", report.path.c_str());
+                else
+                    std::printf("FAILED  %s: %s\n", report.path.c_str(), report.error.what());
+            }
+        };
+
+        /** @brief Keeps every report. */
+        class RecordingReporter : public Reporter
+        {
+            std::mutex m_mutex;
+            std::vector < Report > m_reports;
+
+        public:
+            void report(const Report& report)
+            {
+                std::lock_guard < std::mutex > lock(m_mutex);
+                m_reports.push_back(report);
+            }
+
+            /** @brief Returns the reports of the given kind. */
+            std::vector < Report > reports(ReportKind kind)
+            {
+                std::lock_guard < std::mutex > lock(m_mutex);
+                std::vector < Report > result;
+
+                for (const Report& report : m_reports)
+                {
+                    if (report.kind == kind)
+                        result.push_back(report);
+                }
+
+                return result;
+            }
+        };
+
+        /** @brief Throws with the given message if the condition is false. */
+        inline void check(bool condition, const std::string& message)
+        {
+            if (!condition)
+                throw std::runtime_error(message);
+        }
+
+        /** @brief Returns the path of a file in \ref g_directory. */
+        inline std::string test_file(const std::string& name)
+        {
+            return g_directory + "/" + name;
+        }
+
+        /** @brief Adds a named void unit to the test. */
+        inline void add_test(Test& test, const std::string& name, void(*function)())
+        {
+            std::shared_ptr < UnitBase > unit = make_unit(function);
+            unit->setName(name);
+            test.addUnit(unit);
+        }
+
+        /** @brief Runs every unit of the test and returns the exit code of the test program. */
+        inline int run_tests(Test& test, int argc, char** argv)
+        {
+            if (argc > 1)
+                g_directory = argv[1];
+
+            test.setShard(Shard());
+            test.setBreakOnError(false);
+            test.setReporter(std::make_shared < PrintingReporter >());
+
+            return test.run() ? EXIT_SUCCESS : EXIT_FAILURE;
+        }
+    }
+}
+
+#endif /* ATTestSupport_h */
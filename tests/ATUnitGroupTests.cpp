@@ -0,0 +1,160 @@
+//
+//  ATUnitGroupTests.cpp
+//  ATest
+//
+//  Checks that a failure cancels the units of every worker, that the next run starts again, and that the history
+//  orders the units.
+//
+
+#include "ATTestSupport.h"
+#include "ATResultLog.h"
+
+using namespace ATest;
+using namespace ATest::Tests;
+
+namespace
+{
+    //! @brief The number of units runned by the slow subgroups.
+    std::atomic < int > g_slow_runs(0);
+
+    bool fail_after(int milliseconds)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(milliseconds));
+        return false;
+    }
+
+    bool slow()
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        g_slow_runs++;
+        return true;
+    }
+
+    /** @brief Returns a group whose only unit fails after 20 ms. */
+    std::shared_ptr < UnitGroup > failing_group()
+    {
+        auto group = std::make_shared < UnitGroup >();
+        group->setName("failing");
+        group->addUnit(make_unit(true, fail_after, 20));
+        return group;
+    }
+
+    /** @brief Returns a group of 50 units lasting 10 ms. */
+    std::shared_ptr < UnitGroup > slow_group(const std::string& name)
+    {
+        auto group = std::make_shared < UnitGroup >();
+        group->setName(name);
+
+        for (int i = 0; i < 50; ++i)
+            group->addUnit(make_unit(true, slow));
+
+        return group;
+    }
+
+    void cancels_other_workers()
+    {
+        Test test("workers");
+        test.addUnit(failing_group());
+        test.addUnit(slow_group("slow"));
+        test.setWorkers(2);
+
+        g_slow_runs = 0;
+        check(!test.run(), "the run succeeded");
+        check(g_slow_runs < 10, "the other worker ran " + std::to_string(g_slow_runs) + " units after the failure");
+    }
+
+    void shared_cancellation_runs_again()
+    {
+        auto cancellation = std::make_shared < Cancellation >();
+        Test test("shared");
+        test.addUnit(make_unit(true, fail_after, 0));
+        test.setCancellation(cancellation);
+
+        check(!test.run(), "the first run succeeded");
+        check(test.error().code() == EReturnedError, "the first run wasn't stopped by its failure");
+        check(cancellation->isCancelled(), "the failure didn't cancel the shared Cancellation");
+        check(!test.run(), "the second run succeeded");
+        check(test.error().code() == EReturnedError, "the second run didn't run its unit");
+    }
+
+    void non_breaking_group_isolates_subgroups()
+    {
+        Test test("isolated");
+        test.addUnit(failing_group());
+        test.addUnit(slow_group("slow"));
+        test.setWorkers(2);
+        test.setBreakOnError(false);
+
+        g_slow_runs = 0;
+        check(!test.run(), "the run succeeded");
+        check(g_slow_runs == 50, "the failure of a subgroup stopped its sibling after "
+              + std::to_string(g_slow_runs) + " units");
+    }
+
+    bool pass()
+    {
+        return true;
+    }
+
+    void history_order()
+    {
+        std::string path = test_file("order.atrl");
+
+        {
+            ResultLogWriter writer(path);
+            const std::pair < const char*, int64_t > previous[] = {
+                { "ordered/fast", 10 }, { "ordered/slow", 1000000000 }, { "ordered/failed", 1 }
+            };
+
+            for (const auto& unit : previous)
+            {
+                Report report;
+                report.path = unit.first;
+                report.id = unit_id(report.path);
+                report.duration = std::chrono::nanoseconds(unit.second);
+
+                if (report.path == "ordered/failed")
+                    report.error = Error(EReturnedError, "failed");
+
+                writer.report(report);
+            }
+
+            writer.close();
+        }
+
+        auto history = std::make_shared < History >();
+        history->record(ResultLog(path));
+
+        auto reporter = std::make_shared < RecordingReporter >();
+        Test test("ordered");
+
+        for (const char* name : { "fast", "slow", "new", "failed" })
+        {
+            auto unit = make_unit(true, pass);
+            unit->setName(name);
+            test.addUnit(unit);
+        }
+
+        test.setHistory(history);
+        test.setReporter(reporter);
+        test.run();
+
+        std::string order;
+
+        for (const Report& report : reporter->reports(EUnitReport))
+            order += report.path + " ";
+
+        check(order == "ordered/failed ordered/new ordered/slow ordered/fast ", "the units ran in the order " + order);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    Test test("unit_group");
+    add_test(test, "cancels_other_workers", cancels_other_workers);
+    add_test(test, "shared_cancellation_runs_again", shared_cancellation_runs_again);
+    add_test(test, "non_breaking_group_isolates_subgroups", non_breaking_group_isolates_subgroups);
+    add_test(test, "history_order", history_order);
+
+    return run_tests(test, argc, argv);
+}
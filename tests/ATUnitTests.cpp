@@ -0,0 +1,175 @@
+//
+//  ATUnitTests.cpp
+//  ATest
+//
+//  Checks the ways a Unit holds its expected result, and compares results to golden files.
+//
+
+#include "ATTestSupport.h"
+#include "ATGoldenFile.h"
+
+#include <cstdio>
+#include <fstream>
+
+using namespace ATest;
+using namespace ATest::Tests;
+
+namespace
+{
+    /** @brief A value counting its copies. */
+    struct Counted
+    {
+        //! @brief The number of copies of any Counted.
+        static int copies;
+
+        int value = 0;
+
+        explicit Counted(int value_) : value(value_) {}
+        Counted(const Counted& rhs) : value(rhs.value) { copies++; }
+        Counted(Counted&& rhs) = default;
+
+        bool operator==(const Counted& rhs) const
+        {
+            return value == rhs.value;
+        }
+    };
+
+    int Counted::copies = 0;
+
+    Counted make_counted(int value)
+    {
+        return Counted(value);
+    }
+
+    int identity(int value)
+    {
+        return value;
+    }
+
+    std::vector < int > sequence(int count)
+    {
+        std::vector < int > result;
+
+        for (int i = 0; i < count; ++i)
+            result.push_back(i);
+
+        return result;
+    }
+
+    std::string text(const std::string& value)
+    {
+        return value;
+    }
+
+    void moved_result()
+    {
+        Counted::copies = 0;
+        auto passing = make_unit(Counted(3), make_counted, 3);
+        auto failing = make_unit(Counted(3), make_counted, 4);
+
+        check(Counted::copies == 0, "the expected result was copied " + std::to_string(Counted::copies) + " times");
+        check(passing->run(), "the unit failed with the expected result");
+        check(!failing->run() && failing->error().code() == EResultInvalid, "a wrong result wasn't spotted");
+        check(Counted::copies == 0, "the result was copied " + std::to_string(Counted::copies) + " times");
+    }
+
+    void referenced_result()
+    {
+        int expected = 5;
+        auto unit = make_unit(std::cref(expected), identity, 5);
+        check(unit->run(), "the unit failed with the expected result");
+
+        // The unit compares to the caller's value, not to a copy of it.
+        expected = 6;
+        check(!unit->run() && unit->error().code() == EResultInvalid, "the unit kept a copy of the result");
+    }
+
+    void shared_result()
+    {
+        auto expected = std::make_shared < const std::vector < int > >(sequence(1000));
+
+        {
+            auto first = make_unit(expected, sequence, 1000);
+            auto second = make_unit(expected, sequence, 999);
+
+            check(expected.use_count() == 3, "the units don't share the expected result");
+            check(first->run(), "the unit failed with the expected result");
+            check(!second->run() && second->error().code() == EResultInvalid, "a wrong result wasn't spotted");
+        }
+
+        check(expected.use_count() == 1, "the units didn't release the expected result");
+    }
+
+    /** @brief Writes a golden file holding 'content'. */
+    std::string write_golden(const std::string& name, const std::string& content)
+    {
+        std::string path = test_file(name);
+        std::ofstream(path, std::ios::binary) << content;
+        return path;
+    }
+
+    void golden_compare()
+    {
+        GoldenFile golden(write_golden("compare.golden", "abcdef"));
+
+        check(golden.size() == 6, "the golden file has the wrong size");
+        check(golden.compare("abcdef", 6) == GoldenFile::npos, "equal bytes differ");
+        check(golden.compare("abcXef", 6) == 3, "the first difference isn't at byte 3");
+        check(golden.compare("abc", 3) == 3, "shorter bytes don't differ at their end");
+        check(golden.compare("abcdefgh", 8) == 6, "longer bytes don't differ at the end of the file");
+
+        // The difference is searched inside the first block of 64 KiB that differs.
+        std::string large(200000, 'x');
+        GoldenFile large_golden(write_golden("large.golden", large));
+        large[150001] = 'y';
+        check(large_golden.compare(large.data(), large.size()) == 150001, "the difference in a later block was missed");
+    }
+
+    void golden_unit()
+    {
+        std::string path = write_golden("unit.golden", "hello golden");
+
+        auto passing = make_golden_unit(path, text, std::string("hello golden"));
+        check(passing->run(), std::string("the unit failed: ") + passing->error().what());
+
+        auto failing = make_golden_unit(path, text, std::string("hello world!"));
+        check(!failing->run() && failing->error().code() == EResultInvalid, "a wrong result wasn't spotted");
+        check(std::string(failing->error().what()).find("at byte 6") != std::string::npos,
+              std::string("the error doesn't give the offset: ") + failing->error().what());
+    }
+
+    void missing_golden_file()
+    {
+        std::string path = test_file("missing.golden");
+        std::remove(path.c_str());
+
+        try
+        {
+            GoldenFile golden(path);
+            check(false, "a missing golden file was mapped");
+        }
+
+        catch(const Error& error)
+        {
+            check(error.code() == EFileError, "a missing golden file throws the wrong error");
+        }
+
+        auto unit = make_golden_unit(path, text, std::string("anything"));
+        check(!unit->run() && unit->error().code() == EReturnedError, "a missing golden file didn't fail the unit");
+        check(std::string(unit->error().what()).find(path) != std::string::npos,
+              std::string("the error doesn't name the golden file: ") + unit->error().what());
+    }
+}
+
+int main(int argc, char** argv)
+{
+    Test test("unit");
+    add_test(test, "moved_result", moved_result);
+    add_test(test, "referenced_result", referenced_result);
+    add_test(test, "shared_result", shared_result);
+    add_test(test, "golden_compare", golden_compare);
+    add_test(test, "golden_unit", golden_unit);
+    add_test(test, "missing_golden_file", missing_golden_file);
+
+    return run_tests(test, argc, argv);
+}
@@ -0,0 +1,215 @@
+//
+//  ATLogTool.cpp
+//  ATest
+//
+//  Created by jacques tronconi on 19/10/2026.
+//
+//  Queries and merges the binary result logs written by ResultLogWriter, and records them into History files.
+//
+
+#include "ATHistory.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+
+using namespace ATest;
+
+namespace
+{
+    const char* kind_name(const ResultRecord& record)
+    {
+        switch (record.kind)
+        {
+            case EGroupReport: return "group";
+            case EFixtureReport: return "fixture";
+            default: return "unit";
+        }
+    }
+
+    double milliseconds(int64_t nanoseconds)
+    {
+        return static_cast < double >(nanoseconds) / 1000000.0;
+    }
+
+    void print_usage()
+    {
+        std::fprintf(stderr,
+                     "usage: atest-log summary <log>\n"
+                     "       atest-log failures <log>\n"
+                     "       atest-log slowest <log> [count]\n"
+                     "       atest-log diff <before> <after> [count]\n"
+                     "       atest-log merge <output> <log>...\n"
+                     "       atest-log history <history> <log>...\n");
+    }
+
+    int summary(const ResultLog& log)
+    {
+        size_t units = 0, failed = 0;
+        int64_t duration = 0;
+
+        for (const ResultRecord& record : log)
+        {
+            if (record.kind != EUnitReport)
+                continue;
+
+            units++;
+            failed += record.passed() ? 0 : 1;
+            duration += record.duration;
+        }
+
+        std::printf("%zu records, %zu units, %zu failed, %.3f ms in units\n",
+                    log.size(), units, failed, milliseconds(duration));
+
+        return failed == 0 ? 0 : 1;
+    }
+
+    int print_failures(const ResultLog& log)
+    {
+        auto records = failures(log);
+
+        for (const ResultRecord* record : records)
+        {
+            std::printf("%-7s %s: [%u] %s\n", kind_name(*record), log.name(*record),
+                        static_cast < unsigned >(record->code), log.message(*record));
+        }
+
+        return records.empty() ? 0 : 1;
+    }
+
+    int print_slowest(const ResultLog& log, size_t count)
+    {
+        for (const ResultRecord* record : slowest(log, count))
+            std::printf("%12.3f ms  %-7s %s\n", milliseconds(record->duration), kind_name(*record), log.name(*record));
+
+        return 0;
+    }
+
+    int print_diff(const ResultLog& before, const ResultLog& after, size_t count)
+    {
+        auto entries = diff(before, after);
+        std::vector < const ResultDiff* > common;
+        int status = 0;
+
+        for (const ResultDiff& entry : entries)
+        {
+            if (!entry.before)
+                std::printf("added     %s\n", after.name(*entry.after));
+
+            else if (!entry.after)
+                std::printf("removed   %s\n", before.name(*entry.before));
+
+            else
+            {
+                if (!entry.before->failed() && entry.after->failed())
+                {
+                    std::printf("broken    %s: %s\n", after.name(*entry.after), after.message(*entry.after));
+                    status = 1;
+                }
+
+                else if (entry.before->failed() && !entry.after->failed())
+                    std::printf("fixed     %s\n", after.name(*entry.after));
+
+                common.push_back(&entry);
+            }
+        }
+
+        auto delta = [](const ResultDiff* entry) {
+            return entry->after->duration - entry->before->duration;
+        };
+
+        count = std::min(count, common.size());
+        std::partial_sort(common.begin(), common.begin() + count, common.end(),
+                          [&delta](const ResultDiff* lhs, const ResultDiff* rhs) { return delta(lhs) > delta(rhs); });
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            if (delta(common[i]) <= 0)
+                break;
+
+            std::printf("slower    %+12.3f ms  %s\n", milliseconds(delta(common[i])), after.name(*common[i]->after));
+        }
+
+        return status;
+    }
+
+    int merge_logs(const std::string& output, const std::vector < std::string >& inputs)
+    {
+        std::vector < ResultLog > logs;
+
+        for (const std::string& input : inputs)
+            logs.emplace_back(input);
+
+        ResultLogWriter writer(output);
+
+        for (const ResultLog& log : logs)
+            merge(log, writer);
+
+        writer.close();
+        std::printf("%llu records merged into %s\n", static_cast < unsigned long long >(writer.size()), output.c_str());
+
+        return 0;
+    }
+
+    int update_history(const std::string& path, const std::vector < std::string >& inputs)
+    {
+        std::vector < ResultLog > logs;
+        std::vector < const ResultLog* > pointers;
+
+        for (const std::string& input : inputs)
+            logs.emplace_back(input);
+
+        for (const ResultLog& log : logs)
+            pointers.push_back(&log);
+
+        History history = History::load(path);
+        history.record(pointers);
+        history.save(path);
+
+        std::printf("%zu units in %s, generation %llu\n", history.size(), path.c_str(),
+                    static_cast < unsigned long long >(history.generation()));
+
+        return 0;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    if (argc < 3)
+    {
+        print_usage();
+        return 2;
+    }
+
+    std::string command = argv[1];
+
+    try
+    {
+        if (command == "summary" && argc == 3)
+            return summary(ResultLog(argv[2]));
+
+        if (command == "failures" && argc == 3)
+            return print_failures(ResultLog(argv[2]));
+
+        if (command == "slowest" && argc <= 4)
+            return print_slowest(ResultLog(argv[2]), argc == 4 ? std::strtoull(argv[3], nullptr, 10) : 10);
+
+        if (command == "diff" && argc >= 4 && argc <= 5)
+            return print_diff(ResultLog(argv[2]), ResultLog(argv[3]), argc == 5 ? std::strtoull(argv[4], nullptr, 10) : 10);
+
+        if (command == "merge" && argc >= 4)
+            return merge_logs(argv[2], std::vector < std::string >(argv + 3, argv + argc));
+
+        if (command == "history" && argc >= 4)
+            return update_history(argv[2], std::vector < std::string >(argv + 3, argv + argc));
+    }
+
+    catch(const std::exception& e)
+    {
+        std::fprintf(stderr, "atest-log: %s\n", e.what());
+        return 2;
+    }
+
+    print_usage();
+    return 2;
+}